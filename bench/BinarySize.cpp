@@ -0,0 +1,51 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "logger/Sinks/BinaryFileSink.h"
+#include "logger/Sinks/LogFileSink.h"
+
+/**
+ * @brief   Compares the size of a binary file to the size of a log file with
+ *          the same 800k logs, made by 4 threads.
+ */
+int main(const int argc, const char* argv[])
+{
+    Logger& logger = Logger::getInstance();
+
+    std::filesystem::remove_all("bench_output");
+    std::filesystem::create_directories("bench_output");
+
+    logger.addSink<logger::LogFileSink>("bench_output/logs.log");
+    logger.addSink<logger::BinaryFileSink>("bench_output/logs.shlog");
+    Logger::initialize("BinarySize", argc, argv, logger::BuildInfo::unknown());
+
+    std::vector<std::jthread> threads;
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            static constexpr const char* kLabels[] = { "Producer 0", "Producer 1", "Producer 2", "Producer 3" };
+
+            logger::setThreadLabel(kLabels[t]);
+            for (int k = 0; k < 200'000; ++k) {
+                LOG_INFO("request {} served in {} us", k, k % 997);
+            }
+        });
+    }
+    threads.clear();
+    logger.shutdown();
+
+    const auto text = std::filesystem::file_size("bench_output/logs.log");
+    const auto binary = std::filesystem::file_size("bench_output/logs.shlog");
+
+    std::printf(
+        "log: %ju bytes, shlog: %ju bytes (%.1fx smaller)\n",
+        static_cast<uintmax_t>(text),
+        static_cast<uintmax_t>(binary),
+        static_cast<double>(text) / static_cast<double>(binary)
+    );
+    return 0;
+}
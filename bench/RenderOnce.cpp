@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#include "logger/Logger.h"
+#include "logger/RenderCache.h"
+#include "logger/Sinks/JsonFileSink.h"
+#include "logger/Sinks/LogFileSink.h"
+#include "logger/Sinks/NdJsonFileSink.h"
+
+/**
+ * @class   Unshared
+ * @brief   A sink that renders every batch on its own, like sinks did before
+ *          formats were rendered once per batch for all of them.
+ */
+template<typename Base>
+class Unshared final : public Base
+{
+public:
+    using Base::Base;
+
+    void writeRendered(const std::span<const Log> logs, logger::RenderCache& /*cache*/) override
+    {
+        _cache.reset(logs);
+        Base::writeRendered(logs, _cache);
+    }
+
+private:
+    logger::RenderCache _cache;
+};
+
+template<typename Base>
+using Shared = Base;
+
+template<template<typename> typename Wrap>
+static void addSinks(Logger& logger)
+{
+    logger.addSink<Wrap<logger::LogFileSink>>("bench_output/first.log");
+    logger.addSink<Wrap<logger::LogFileSink>>("bench_output/second.log");
+    logger.addSink<Wrap<logger::JsonFileSink>>("bench_output/logs.json");
+    logger.addSink<Wrap<logger::NdJsonFileSink>>("bench_output/logs.ndjson");
+}
+
+/**
+ * @brief   Times 400k logs through two log files, a JSON file and a NDJSON
+ *          file, from the first log until the Logger has written them all.
+ *
+ * Pass @code --unshared@endcode to have each sink render its batches by
+ * itself, for comparison.
+ */
+int main(const int argc, const char* argv[])
+{
+    const bool isUnshared = argc > 1 && std::string_view(argv[1]) == "--unshared";
+    Logger& logger = Logger::getInstance();
+
+    std::filesystem::remove_all("bench_output");
+    std::filesystem::create_directories("bench_output");
+
+    if (isUnshared) {
+        addSinks<Unshared>(logger);
+    } else {
+        addSinks<Shared>(logger);
+    }
+    Logger::initialize("RenderOnce", argc, argv, logger::BuildInfo::unknown());
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int k = 0; k < 400'000; ++k) {
+        LOG_INFO("request {} served in {} us", k, k % 997);
+    }
+    logger.shutdown();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%s: 400000 logs in %.3f s\n", isUnshared ? "unshared" : "shared", elapsed.count());
+    return 0;
+}
@@ -0,0 +1,210 @@
+#ifndef SHUVLOG_BINARYFORMAT_H
+#define SHUVLOG_BINARYFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "Sink.h"
+
+/**
+ * @brief   Layout of the files written by @code logger::BinaryFileSink@endcode,
+ *          and read back by @code shuvlog-decode@endcode.
+ *
+ * A file starts with @code kMagic@endcode and @code kVersion@endcode, followed
+ * by framed records: a @code Record@endcode tag byte, the payload size as a
+ * varint, then the payload.
+ * Unknown record tags can then be skipped by readers.
+ *
+ * Payloads (integers are unsigned LEB128 varints, strings are a varint size
+ * followed by raw bytes):
+ *   - @code kHeader@endcode:   count, then count (key, value) string pairs
+ *   - @code kSettings@endcode: the sink's @code sink::Settings@endcode, as
+ *                              a varint of flags (see @code Setting@endcode)
+ *   - @code kThread@endcode:   thread id, label, pretty id
+ *   - @code kCallsite@endcode: callsite id, line, column, file, function
+ *   - @code kSync@endcode:     absolute timestamp (nanoseconds since epoch)
+ *   - @code kLog@endcode:      zigzag timestamp delta from the previous log
+ *                              (or sync), level index, thread id, callsite
+ *                              id, then the raw message up to the end of the
+ *                              payload
+ *   - @code kSampledLog@endcode: same as @code kLog@endcode, with the sample
+ *                              rate after the callsite id
+ *
+ * Thread and callsite ids are defined once, before their first use, and are
+ * never redefined: a relabeled thread gets a new id.
+ * A sync record starts every batch, so that a reader can start decoding at
+ * any of them.
+ */
+namespace logger::binary
+{
+
+    inline constexpr std::string_view kMagic = "SHUVLOG";
+    inline constexpr uint8_t kVersion = 1;
+    inline constexpr std::string_view kExtension = ".shlog";
+
+    enum class Record : uint8_t
+    {
+        kHeader = 1,
+        kThread = 2,
+        kCallsite = 3,
+        kSync = 4,
+        kLog = 5,
+        kSampledLog = 6,
+        kSettings = 7,
+    };
+
+    /**
+     * @brief   Bits of the @code kSettings@endcode record, one per
+     *          @code sink::Settings@endcode flag.
+     */
+    enum class Setting : uint64_t
+    {
+        kShowTimestamp = 1 << 0,
+        kShowOnlyTime = 1 << 1,
+        kShowMilliseconds = 1 << 2,
+        kShowThreadInfo = 1 << 3,
+        kShowThreadId = 1 << 4,
+        kShowSource = 1 << 5,
+        kShowLineNumber = 1 << 6,
+        kShowColumnNumber = 1 << 7,
+    };
+
+    /// Every flag of @code sink::Settings@endcode, and its bit.
+    inline constexpr std::pair<bool sink::Settings::*, Setting> kSettingBits[] = {
+        { &sink::Settings::showTimestamp,       Setting::kShowTimestamp     },
+        { &sink::Settings::showOnlyTime,        Setting::kShowOnlyTime      },
+        { &sink::Settings::showMilliseconds,    Setting::kShowMilliseconds  },
+        { &sink::Settings::showThreadInfo,      Setting::kShowThreadInfo    },
+        { &sink::Settings::showThreadId,        Setting::kShowThreadId      },
+        { &sink::Settings::showSource,          Setting::kShowSource        },
+        { &sink::Settings::showLineNumber,      Setting::kShowLineNumber    },
+        { &sink::Settings::showColumnNumber,    Setting::kShowColumnNumber  },
+    };
+
+    inline uint64_t toFlags(const sink::Settings& settings)
+    {
+        uint64_t flags = 0;
+
+        for (const auto& [member, bit] : kSettingBits) {
+            if (settings.*member) {
+                flags |= static_cast<uint64_t>(bit);
+            }
+        }
+        return flags;
+    }
+
+    inline sink::Settings toSettings(const uint64_t flags)
+    {
+        sink::Settings settings;
+
+        for (const auto& [member, bit] : kSettingBits) {
+            settings.*member = (flags & static_cast<uint64_t>(bit)) != 0;
+        }
+        return settings;
+    }
+
+    inline void appendVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    inline std::size_t varintSize(uint64_t value)
+    {
+        std::size_t size = 1;
+
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    inline void appendString(std::string& out, const std::string_view value)
+    {
+        appendVarint(out, value.size());
+        out += value;
+    }
+
+    inline uint64_t zigzag(const int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t unzigzag(const uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /**
+     * @brief   Sequential reader over a record payload (or a whole file).
+     *
+     * Every read returns @code std::nullopt@endcode once the input is
+     * exhausted or malformed.
+     */
+    class Cursor final
+    {
+    public:
+        explicit Cursor(const std::string_view data) : _data(data) {}
+
+        [[nodiscard]] std::optional<uint64_t> readVarint()
+        {
+            uint64_t value = 0;
+
+            for (int shift = 0; shift < 64 && _offset < _data.size(); shift += 7) {
+                const auto byte = static_cast<uint8_t>(_data[_offset++]);
+
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] std::optional<std::string_view> readBytes(const std::size_t size)
+        {
+            if (size > _data.size() - _offset) {
+                return std::nullopt;
+            }
+
+            const std::string_view bytes = _data.substr(_offset, size);
+
+            _offset += size;
+            return bytes;
+        }
+
+        [[nodiscard]] std::optional<std::string_view> readString()
+        {
+            const auto size = readVarint();
+
+            return size ? readBytes(*size) : std::nullopt;
+        }
+
+        /// @return Whatever hasn't been read yet
+        [[nodiscard]] std::string_view rest()
+        {
+            const std::string_view bytes = _data.substr(_offset);
+
+            _offset = _data.size();
+            return bytes;
+        }
+
+        [[nodiscard]] std::size_t getOffset() const { return _offset; }
+        [[nodiscard]] bool atEnd() const { return _offset >= _data.size(); }
+
+    private:
+        std::string_view _data;
+        std::size_t _offset = 0;
+    };
+
+}
+
+#endif //SHUVLOG_BINARYFORMAT_H
@@ -0,0 +1,95 @@
+#ifndef SHUVLOG_CALLSITE_H
+#define SHUVLOG_CALLSITE_H
+
+#include <atomic>
+#include <cstdint>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Level.h"
+
+namespace logger
+{
+
+/**
+ * @struct  Callsite
+ * @brief   Static description of a logging statement: its level, and where it
+ *          is in the source code.
+ *
+ * Each @code LOG_*@endcode macro expansion registers its own in the
+ * @code logger::CallsiteRegistry@endcode, the first time it logs. Logs only
+ * carry a pointer to it, that sinks use to render what only depends on the
+ * call site once for all (see @code logger::CallsiteCache@endcode).
+ *
+ * Logs made from a plain @code std::source_location@endcode (e.g. with
+ * @code Logger::log()@endcode) get theirs from
+ * @code logger::CallsiteRegistry::intern()@endcode.
+ *
+ * Call sites live until the end of the process, at the same address.
+ */
+struct Callsite
+{
+    /**
+     * @param   enabled Flag of the call site, owned by its macro expansion
+     */
+    constexpr Callsite(const Level level, const std::source_location& loc, std::atomic<bool>& enabled)
+        : level(level)
+        , file(loc.file_name())
+        , function(loc.function_name())
+        , line(loc.line())
+        , column(loc.column())
+        , enabled(enabled)
+    {}
+
+    Callsite(const Callsite&) = delete;
+    Callsite& operator=(const Callsite&) = delete;
+
+    /// @return Whether the call site logs (see @code logger::CallsiteRegistry@endcode)
+    [[nodiscard]] bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    Level level;
+    std::string_view file;
+    std::string_view function;
+    uint32_t line;
+    uint32_t column;
+    std::atomic<bool>& enabled;
+};
+
+/**
+ * @class   CallsiteCache
+ * @brief   Text rendered once per call site (e.g. the source of a line), and
+ *          looked up by the call site's address afterward.
+ *
+ * @warning Not thread-safe.
+ */
+class CallsiteCache final
+{
+public:
+    /**
+     * @param   site    Call site to get the text of
+     * @param   render  Called with an empty string to render the text into,
+     *                  the first time the call site is seen
+     * @return  The text of the call site, valid until @code clear()@endcode.
+     */
+    template<typename Render>
+    std::string_view get(const Callsite& site, Render&& render)
+    {
+        const auto [it, isNew] = _rendered.try_emplace(&site);
+
+        if (isNew) {
+            render(it->second);
+        }
+        return it->second;
+    }
+
+    void clear() { _rendered.clear(); }
+
+private:
+    std::unordered_map<const Callsite*, std::string> _rendered;
+};
+
+}
+
+#endif //SHUVLOG_CALLSITE_H
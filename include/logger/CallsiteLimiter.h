@@ -0,0 +1,194 @@
+#ifndef SHUVLOG_CALLSITELIMITER_H
+#define SHUVLOG_CALLSITELIMITER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "Callsite.h"
+#include "Level.h"
+#include "Settings.h"
+
+namespace logger
+{
+
+/**
+ * @struct  RepeatKey
+ * @brief   Describes whether (and how) a format argument can be hashed to
+ *          detect repeated messages without formatting them.
+ *
+ * Numbers, enums, strings and character pointers (by content) are hashed.
+ * Logs with other arguments are formatted first, and their message is hashed
+ * instead.
+ *
+ * @tparam  T   Argument type, without reference nor cv-qualifiers
+ */
+template<typename T>
+struct RepeatKey
+{
+    /// Character pointers and arrays (but not plain characters), hashed by content.
+    static constexpr bool kIsCString =
+        std::is_pointer_v<std::decay_t<T>>
+        && std::is_same_v<std::remove_const_t<std::remove_pointer_t<std::decay_t<T>>>, char>;
+
+    static constexpr bool kEnabled =
+        std::is_arithmetic_v<T>
+        || std::is_enum_v<T>
+        || std::is_same_v<T, std::string>
+        || std::is_same_v<T, std::string_view>
+        || kIsCString;
+
+    static uint64_t hash(const T& value)
+    {
+        if constexpr (kIsCString) {
+            const char* string = value;
+
+            // a sentinel, rather than reading through a null pointer.
+            if (string == nullptr) {
+                return 0x6e756c6c;
+            }
+            return std::hash<std::string_view>{}(std::string_view(string));
+        } else if constexpr (std::is_enum_v<T>) {
+            return std::hash<std::underlying_type_t<T>>{}(static_cast<std::underlying_type_t<T>>(value));
+        } else {
+            return std::hash<T>{}(value);
+        }
+    }
+};
+
+/**
+ * @class   CallsiteLimiter
+ * @brief   Per-call-site rate limiting and repeat collapsing, checked by
+ *          producers before formatting anything.
+ *
+ * Call sites are told apart by their @code logger::Callsite@endcode, and get
+ * their state from a fixed-size, lock-free, open-addressing table.
+ * A flood from a single call site thus costs a lookup and a couple of atomic
+ * operations per log, and never reaches the queue.
+ *
+ * - Rate limiting is a token bucket per call site, refilled at the rate of
+ *   the log's level (see @code logger::Settings::setRateLimit()@endcode).
+ *   Rejected logs are counted, and reported by the next accepted one (or at
+ *   shutdown).
+ * - Repeat collapsing drops a log whose arguments (or message) are the same
+ *   as the previous one of its call site, and counts it. The count is
+ *   reported when the call site logs something else, at least once per
+ *   second while the repeats go on, and at shutdown.
+ *
+ * @note    Under contention, counts are exact, but which thread reports them
+ *          isn't. Once the table is full, new call sites are not limited.
+ */
+class CallsiteLimiter final
+{
+public:
+    /// Number of distinct call sites that can be tracked (a power of two).
+    static constexpr std::size_t kCapacity = 2048;
+
+    /**
+     * @brief   Whether every argument of a call can be hashed.
+     */
+    template<typename... Args>
+    static constexpr bool kHashable = (RepeatKey<std::remove_cvref_t<Args>>::kEnabled && ...);
+
+    /**
+     * @return  A hash of the arguments of a call.
+     */
+    template<typename... Args>
+    static uint64_t hashArgs(const Args&... args)
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+
+        ((hash = combine(hash, RepeatKey<std::remove_cvref_t<Args>>::hash(args))), ...);
+        return hash;
+    }
+
+    /**
+     * @return  A hash of a formatted message.
+     */
+    static uint64_t hashMessage(const std::string_view message)
+    {
+        return combine(0x84222325cbf29ce4, std::hash<std::string_view>{}(message));
+    }
+
+    /**
+     * @brief   Takes the rate limits and repeat collapsing from the settings.
+     *
+     * @warning Must be called before any log is checked.
+     */
+    void configure(const Settings& settings);
+
+    /// @return Whether logs are rate limited (at any level).
+    [[nodiscard]] bool isLimiting() const { return _isLimiting; }
+
+    /// @return Whether repeated messages are collapsed.
+    [[nodiscard]] bool isCollapsing() const { return _isCollapsing; }
+
+    /**
+     * @brief   Takes a token from the call site's bucket.
+     *
+     * @param   site        Call site of the log
+     * @param   suppressed  Set to the number of logs rejected since the last
+     *                      accepted one, to report (when accepted)
+     * @return  @code false@endcode if the log must be dropped.
+     */
+    bool admit(const Callsite& site, uint64_t& suppressed);
+
+    /**
+     * @brief   Compares a log to the previous one of its call site.
+     *
+     * @param   site        Call site of the log
+     * @param   hash        Hash of the log's arguments, or of its message
+     * @param   repeated    Set to the number of repeats collapsed so far, to
+     *                      report (when not collapsed)
+     * @return  @code true@endcode if the log is a repeat, and must be dropped.
+     */
+    bool collapse(const Callsite& site, uint64_t hash, uint64_t& repeated);
+
+    /**
+     * @brief   Calls @code report(site, suppressed, repeated)@endcode
+     *          for each call site that has rejected logs or collapsed repeats
+     *          not reported yet.
+     */
+    void drain(const std::function<void(const Callsite&, uint64_t, uint64_t)>& report);
+
+private:
+    struct Slot
+    {
+        std::atomic<const Callsite*> site{nullptr}; // nullptr: free
+
+        // token bucket, as the time the bucket is full again (GCRA)
+        std::atomic<int64_t> fullAt{0};
+        std::atomic<uint64_t> suppressed{0};
+
+        std::atomic<uint64_t> lastHash{0};
+        std::atomic<uint64_t> repeats{0};
+        std::atomic<int64_t> reportedAt{0};
+    };
+
+    static uint64_t combine(const uint64_t hash, const uint64_t value)
+    {
+        return (hash ^ (value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2))) * 0x100000001b3;
+    }
+
+    /**
+     * @return  The call site's slot, claimed if it's the first time it's
+     *          seen, or @code nullptr@endcode if the table is full.
+     */
+    Slot* find(const Callsite& site);
+
+    bool _isLimiting = false;
+    bool _isCollapsing = false;
+    std::array<int64_t, level::kCount> _intervals{}; // ns between two tokens, per level
+    std::array<int64_t, level::kCount> _tolerances{}; // ns of burst, per level
+
+    std::array<Slot, kCapacity> _slots;
+};
+
+}
+
+#endif //SHUVLOG_CALLSITELIMITER_H
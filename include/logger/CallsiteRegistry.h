@@ -0,0 +1,157 @@
+#ifndef SHUVLOG_CALLSITEREGISTRY_H
+#define SHUVLOG_CALLSITEREGISTRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Callsite.h"
+#include "Level.h"
+
+namespace logger
+{
+
+/**
+ * @struct  CallsiteFilter
+ * @brief   Selects call sites of the @code logger::CallsiteRegistry@endcode.
+ *
+ * A call site is selected if it matches every criterion. Globs support
+ * @code *@endcode (any sequence) and @code ?@endcode (any character).
+ *
+ * @code
+ * // every TRACE_R1 call site of the network files
+ * logger::CallsiteFilter{ .file = "*network*", .levels = SHUVLOG_LEVEL_TRACE_R1 }
+ * // every call site of a function
+ * logger::CallsiteFilter{ .function = "Session::handshake" }
+ * @endcode
+ */
+struct CallsiteFilter
+{
+    /// Glob of the file path, or of one of its trailing parts (e.g. "Session.cpp", "net/*.cpp"; empty: any file).
+    std::string file;
+    /// Glob of the qualified function name, or of one of its trailing parts (e.g. "parse", "Parser::*"; empty: any function).
+    std::string function;
+    uint32_t firstLine = 0;
+    uint32_t lastLine = std::numeric_limits<uint32_t>::max();
+    /// Mask of @code logger::Level@endcode.
+    uint16_t levels = std::numeric_limits<uint16_t>::max();
+
+    [[nodiscard]] bool matches(const Callsite& site) const;
+
+    bool operator==(const CallsiteFilter&) const = default;
+};
+
+/**
+ * @class   CallsiteRegistry
+ * @brief   Process-wide registry of the call sites that logged, that turns
+ *          them on and off at runtime.
+ *
+ * Each @code LOG_*@endcode macro expansion has its own enabled flag,
+ * checked before anything else: a disabled call site costs a single relaxed
+ * atomic load, and neither evaluates its arguments nor formats anything.
+ *
+ * Call sites are registered the first time they're reached with their level
+ * enabled. Calls to @code enable()@endcode and @code disable()@endcode apply
+ * to the call sites registered so far, and are kept as rules for the ones
+ * registered later (the last matching rule wins).
+ *
+ * @code
+ * auto& callsites = Logger::getInstance().getCallsiteRegistry();
+ *
+ * // DEBUG logs off by default...
+ * callsites.disable({ .levels = SHUVLOG_LEVEL_DEBUG });
+ * // ...but for the ones of a file, e.g. on a signal or an admin command.
+ * callsites.enable({ .file = "Session.cpp", .levels = SHUVLOG_LEVEL_DEBUG });
+ * @endcode
+ *
+ * @note    Sinks still filter the logs of enabled call sites by level.
+ */
+class CallsiteRegistry final
+{
+public:
+    static CallsiteRegistry& getInstance();
+
+    CallsiteRegistry(const CallsiteRegistry&) = delete;
+    CallsiteRegistry& operator=(const CallsiteRegistry&) = delete;
+
+    /**
+     * @brief   Registers a macro expansion's call site, turning it on or off
+     *          according to the rules.
+     *
+     * @param   enabled Flag of the call site, that must live until the end
+     *                  of the process
+     * @return  The call site, that lives until the end of the process.
+     */
+    const Callsite& add(Level level, const std::source_location& loc, std::atomic<bool>& enabled);
+
+    /**
+     * @return  The call site of a level and location, registered the first
+     *          time it is asked for.
+     *
+     * @note    Takes a lock, unless the calling thread asked for the same
+     *          call site last time.
+     */
+    const Callsite& intern(Level level, const std::source_location& loc);
+
+    /**
+     * @brief   Turns on the matching call sites, and the ones registered
+     *          later.
+     *
+     * @return  The number of call sites turned on.
+     */
+    std::size_t enable(const CallsiteFilter& filter);
+
+    /**
+     * @brief   Turns off the matching call sites, and the ones registered
+     *          later.
+     *
+     * @return  The number of call sites turned off.
+     */
+    std::size_t disable(const CallsiteFilter& filter);
+
+    /**
+     * @brief   Calls @code visit@endcode with each registered call site, in
+     *          registration order.
+     *
+     * @warning @code visit@endcode must not register call sites (nor log).
+     */
+    void forEach(const std::function<void(const Callsite&)>& visit) const;
+
+private:
+    using Key = std::tuple<const char*, const char*, uint32_t, uint32_t, Level>;
+
+    CallsiteRegistry() = default;
+
+    /**
+     * @brief   Turns the matching call sites on or off, and keeps the rule.
+     */
+    std::size_t apply(const CallsiteFilter& filter, bool isEnabled);
+
+    /**
+     * @brief   Registers a call site and applies the rules to it. The mutex
+     *          must be held.
+     */
+    const Callsite& addLocked(Level level, const std::source_location& loc, std::atomic<bool>& enabled);
+
+    mutable std::mutex _mutex;
+    std::deque<Callsite> _sites;
+    std::vector<std::pair<CallsiteFilter, bool>> _rules;
+
+    // call sites interned from a plain source location, and their flags.
+    std::map<Key, const Callsite*> _interned;
+    std::deque<std::atomic<bool>> _internedFlags;
+};
+
+}
+
+#endif //SHUVLOG_CALLSITEREGISTRY_H
@@ -0,0 +1,62 @@
+#ifndef SHUVLOG_CLOCK_H
+#define SHUVLOG_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#include "Settings.h"
+
+namespace logger::clock
+{
+
+    /**
+     * @brief   Selects the source @code now()@endcode reads ticks from.
+     *
+     * Takes a first calibration sample. With @code ClockSource::kTsc@endcode,
+     * this spins for a few milliseconds to estimate the counter frequency.
+     *
+     * @warning Ticks read before the change can't be converted anymore: the
+     *          source must only be changed while no log is in flight (the
+     *          Logger does it in @code Logger::initialize()@endcode).
+     *
+     * @param   source  Timestamp source
+     */
+    void setSource(ClockSource source);
+
+    /**
+     * @return  The source @code now()@endcode currently reads ticks from.
+     */
+    ClockSource getSource();
+
+    /**
+     * @brief   Reads the current time, as cheaply as the source allows.
+     *
+     * @return  Raw ticks, to be converted with @code toTimePoint()@endcode.
+     */
+    uint64_t now();
+
+    /**
+     * @brief   Converts ticks read by @code now()@endcode to wall-clock time,
+     *          using the latest calibration.
+     *
+     * Can be called from any thread, concurrently with
+     * @code calibrate()@endcode.
+     *
+     * @param   ticks   Raw ticks
+     * @return  The corresponding @code std::chrono::system_clock@endcode time point
+     */
+    std::chrono::time_point<std::chrono::system_clock> toTimePoint(uint64_t ticks);
+
+    /**
+     * @brief   Samples the source against the wall clock, to follow its
+     *          adjustments (NTP, manual changes...) and refine the tick
+     *          frequency.
+     *
+     * Meant to be called periodically, by a single thread (the Logger's
+     * worker). Does nothing with @code ClockSource::kSystem@endcode.
+     */
+    void calibrate();
+
+}
+
+#endif //SHUVLOG_CLOCK_H
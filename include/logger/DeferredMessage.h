@@ -0,0 +1,251 @@
+#ifndef SHUVLOG_DEFERREDMESSAGE_H
+#define SHUVLOG_DEFERREDMESSAGE_H
+
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace logger
+{
+
+namespace detail
+{
+
+    template<typename T>
+    struct IsChrono : std::false_type {};
+
+    template<typename Rep, typename Period>
+    struct IsChrono<std::chrono::duration<Rep, Period>> : std::true_type {};
+
+    template<typename Clock, typename Duration>
+    struct IsChrono<std::chrono::time_point<Clock, Duration>> : std::true_type {};
+
+}
+
+/**
+ * @struct  DeferredArg
+ * @brief   Describes whether (and how) a format argument can be captured on
+ *          the producer thread to be formatted later, on the worker thread.
+ *
+ * By default, only values that can't reference other memory are captured:
+ * arithmetic types, enums, @code void*@endcode, @code std::nullptr_t@endcode,
+ * and @code std::chrono@endcode durations and time points. Anything else
+ * (string views, spans, iterators, structs holding pointers...) may
+ * reference memory that is gone by the time the worker formats it, so logs
+ * using them are formatted right away, like before.
+ *
+ * Other types can opt in by specializing this trait:
+ * @code
+ * template<>
+ * struct logger::DeferredArg<MyType>
+ * {
+ *     static constexpr bool kEnabled = true;
+ *     using Stored = MyType; // must be move-constructible and formattable
+ * };
+ * @endcode
+ *
+ * @tparam  T   Argument type, without reference nor cv-qualifiers
+ */
+template<typename T>
+struct DeferredArg
+{
+    static constexpr bool kEnabled =
+        std::is_arithmetic_v<T>
+        || std::is_enum_v<T>
+        || std::is_same_v<T, void*>
+        || std::is_same_v<T, const void*>
+        || std::is_null_pointer_v<T>
+        || detail::IsChrono<T>::value;
+
+    using Stored = T;
+};
+
+template<>
+struct DeferredArg<std::string>
+{
+    static constexpr bool kEnabled = true;
+    using Stored = std::string;
+};
+
+/**
+ * @class   DeferredMessage
+ * @brief   Compact record of a format string and its captured arguments,
+ *          formatted only when @code render()@endcode is called.
+ *
+ * The format string is kept as a view: it must outlive the record, which is
+ * always the case for the string literals used with the @code LOG_*@endcode
+ * macros.
+ *
+ * Captured arguments are stored inline when they fit in
+ * @code kInlineCapacity@endcode bytes, and on the heap otherwise.
+ */
+class DeferredMessage final
+{
+public:
+    // keeps a record within the inline storage of a log (see Log::kInlineCapacity).
+    static constexpr std::size_t kInlineCapacity = 48;
+    static constexpr std::size_t kInlineAlignment = alignof(void*);
+
+    /**
+     * @brief   Whether every argument of a call can be captured.
+     */
+    template<typename... Args>
+    static constexpr bool kCapturable = (DeferredArg<std::remove_cvref_t<Args>>::kEnabled && ...);
+
+    DeferredMessage() = default;
+
+    /**
+     * @brief   Captures a format string and its arguments.
+     *
+     * @param   format  Format string, that must outlive the record
+     * @param   args    Format arguments, captured according to
+     *                  @code DeferredArg@endcode
+     */
+    template<typename... Args>
+    explicit DeferredMessage(std::string_view format, Args&&... args)
+        : _format(format)
+    {
+        using Tuple = std::tuple<typename DeferredArg<std::remove_cvref_t<Args>>::Stored...>;
+
+        static_assert(kCapturable<Args...>, "Every argument must be capturable (see logger::DeferredArg).");
+
+        _ops = &kOps<Tuple>;
+        if constexpr (fitsInline<Tuple>()) {
+            _args = new (_inline) Tuple(std::forward<Args>(args)...);
+        } else {
+            _args = new Tuple(std::forward<Args>(args)...);
+        }
+    }
+
+    DeferredMessage(const DeferredMessage&) = delete;
+    DeferredMessage& operator=(const DeferredMessage&) = delete;
+
+    DeferredMessage(DeferredMessage&& other) noexcept { moveFrom(other); }
+
+    DeferredMessage& operator=(DeferredMessage&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~DeferredMessage() { reset(); }
+
+    /// @return @code true@endcode if the record holds nothing to format.
+    [[nodiscard]] bool empty() const { return _ops == nullptr; }
+
+    /**
+     * @return  The formatted message. If a formatter throws, the returned
+     *          string describes the error instead.
+     */
+    [[nodiscard]] std::string render() const
+    {
+        std::string message;
+
+        renderTo(message);
+        return message;
+    }
+
+    /**
+     * @brief   Appends the formatted message to @code out@endcode, so that a
+     *          buffer can be reused from one message to the next.
+     */
+    void renderTo(std::string& out) const
+    {
+        if (empty()) {
+            return;
+        }
+
+        const std::size_t initialSize = out.size();
+
+        try {
+            _ops->render(out, _format, _args);
+        } catch (const std::exception& e) {
+            out.resize(initialSize);
+            std::format_to(std::back_inserter(out), "<format error: {}>", e.what());
+        }
+    }
+
+    /**
+     * @brief   Destroys captured arguments. The record becomes empty.
+     */
+    void reset()
+    {
+        if (_ops) {
+            _ops->destroy(_args, isInline());
+        }
+        _ops = nullptr;
+        _args = nullptr;
+    }
+
+private:
+    struct Ops
+    {
+        void (*render)(std::string& out, std::string_view format, const void* args);
+        void (*move)(void* destination, void* source);
+        void (*destroy)(void* args, bool isInline);
+    };
+
+    template<typename Tuple>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(Tuple) <= kInlineCapacity
+            && alignof(Tuple) <= kInlineAlignment
+            && std::is_nothrow_move_constructible_v<Tuple>;
+    }
+
+    template<typename Tuple>
+    static constexpr Ops kOps = {
+        [](std::string& out, std::string_view format, const void* args) {
+            std::apply([&](const auto&... values) {
+                std::vformat_to(std::back_inserter(out), format, std::make_format_args(values...));
+            }, *static_cast<const Tuple*>(args));
+        },
+        [](void* destination, void* source) {
+            new (destination) Tuple(std::move(*static_cast<Tuple*>(source)));
+            static_cast<Tuple*>(source)->~Tuple();
+        },
+        [](void* args, bool isInline) {
+            if (isInline) {
+                static_cast<Tuple*>(args)->~Tuple();
+            } else {
+                delete static_cast<Tuple*>(args);
+            }
+        },
+    };
+
+    [[nodiscard]] bool isInline() const { return _args == static_cast<const void*>(_inline); }
+
+    void moveFrom(DeferredMessage& other) noexcept
+    {
+        _format = other._format;
+        _ops = other._ops;
+
+        if (other.isInline()) {
+            _args = _inline;
+            _ops->move(_inline, other._inline);
+        } else {
+            _args = other._args;
+        }
+        other._ops = nullptr;
+        other._args = nullptr;
+    }
+
+    std::string_view _format;
+    const Ops* _ops = nullptr;
+    void* _args = nullptr;
+    alignas(kInlineAlignment) unsigned char _inline[kInlineCapacity];
+};
+
+}
+
+#endif //SHUVLOG_DEFERREDMESSAGE_H
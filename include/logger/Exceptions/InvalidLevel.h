@@ -9,11 +9,12 @@ namespace logger::exception
 class InvalidLevel : public LoggerException
 {
 public:
-    explicit InvalidLevel()
-        : LoggerException(
+    explicit InvalidLevel(
+        const std::string& what_arg =
             "FilterMode::kMinimumLevel requires a single level, "
             "not a bitwise OR combination."
-        ) {}
+    )
+        : LoggerException(what_arg) {}
 };
 
 }
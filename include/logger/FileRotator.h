@@ -0,0 +1,150 @@
+#ifndef SHUVLOG_FILEROTATOR_H
+#define SHUVLOG_FILEROTATOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace logger
+{
+
+namespace sink
+{
+
+    /**
+     * @brief   How rotated files are compressed.
+     */
+    enum class Compression : uint8_t
+    {
+        kNone,
+        /// gzip (@code .gz@endcode), if the library has been built with zlib. Rotated files are kept as is otherwise.
+        kGzip,
+    };
+
+    /**
+     * @struct  RotationPolicy
+     * @brief   When a file sink starts a new file, and what happens to the
+     *          previous ones.
+     *
+     * A file is rotated as soon as any of the limits is reached. Rotated
+     * files are renamed after their rotation time
+     * (e.g. @code app.2025-11-18_16-59-26.log@endcode), next to the active
+     * one.
+     */
+    struct RotationPolicy
+    {
+        /// Size after which the file is rotated, in bytes (0: unlimited).
+        std::size_t maxBytes = 0;
+        /// Age after which the file is rotated, in seconds (0: unlimited).
+        int64_t maxAgeSeconds = 0;
+        /// Whether the file is rotated at midnight (local time).
+        bool isDaily = false;
+        /// Number of rotated files to keep, the oldest ones being deleted (0: all).
+        std::size_t maxFiles = 0;
+        Compression compression = Compression::kGzip;
+
+        [[nodiscard]] bool isEnabled() const { return maxBytes != 0 || maxAgeSeconds != 0 || isDaily; }
+    };
+
+}
+
+/**
+ * @class   FileRotator
+ * @brief   Background thread of a rotating file sink.
+ *
+ * Keeps the next file opened ahead of time, so that a rotation is only a
+ * couple of renames for the writer, and compresses rotated files (then
+ * enforces the retention policy) without ever making the writer wait.
+ */
+class FileRotator final
+{
+public:
+    /**
+     * @brief   Starts the thread, that immediately opens the next file.
+     *
+     * @param   activePath  Path of the sink's file
+     * @param   extension   Extension of the sink's file (e.g. ".log")
+     * @param   policy      Rotation policy of the sink
+     * @param   openMode    Mode the sink's file is opened with
+     */
+    FileRotator(
+        std::string activePath,
+        std::string extension,
+        const sink::RotationPolicy& policy,
+        std::ios::openmode openMode
+    );
+
+    FileRotator(const FileRotator&) = delete;
+    FileRotator& operator=(const FileRotator&) = delete;
+
+    /**
+     * @brief   Compresses what is still pending, removes the unused next
+     *          file, and stops the thread.
+     */
+    ~FileRotator();
+
+    /**
+     * @return  The next file, opened at @code getNextPath()@endcode, or
+     *          @code nullptr@endcode if it isn't ready yet.
+     */
+    std::unique_ptr<std::fstream> takeNextFile();
+
+    [[nodiscard]] const std::string& getNextPath() const { return _nextPath; }
+
+    /**
+     * @return  A path to rename the active file to, after the current time.
+     *
+     * Files rotated within the same second are numbered in order
+     * (@code app.<time>.1.log@endcode, ...).
+     */
+    [[nodiscard]] std::string makeRotatedPath();
+
+    /**
+     * @brief   Queues a rotated file for compression and retention, and asks
+     *          for a new next file.
+     */
+    void archive(std::string rotatedPath);
+
+private:
+    void run();
+
+    /**
+     * @brief   Compresses a rotated file, replacing it with its compressed
+     *          version on success.
+     */
+    void compress(const std::string& path) const;
+
+    /**
+     * @brief   Deletes the oldest rotated files beyond the retention limit.
+     */
+    void enforceRetention() const;
+
+    const std::string _activePath;
+    const std::string _extension;
+    const std::string _nextPath;
+    const sink::RotationPolicy _policy;
+    const std::ios::openmode _openMode;
+
+    // only used by the writer, in makeRotatedPath()
+    std::string _lastTimestamp;
+    int _lastIndex = 0;
+
+    std::mutex _mutex;
+    std::condition_variable _cvar;
+    std::deque<std::string> _pending;
+    std::unique_ptr<std::fstream> _nextFile;
+    bool _wantsNextFile = true;
+    bool _isStopping = false;
+
+    std::thread _thread;
+};
+
+}
+
+#endif //SHUVLOG_FILEROTATOR_H
@@ -1,8 +1,13 @@
 #ifndef SHUVLOG_FILESINK_H
 #define SHUVLOG_FILESINK_H
 
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
 
+#include "FileRotator.h"
 #include "Sink.h"
 
 namespace logger
@@ -19,6 +24,9 @@ namespace logger
  *
  * By default, a FileSink won't open the filestream if output file doesn't
  * end with the recommended extension.
+ *
+ * Files can be rotated (@code setRotationPolicy()@endcode), in which case the
+ * header is written again at the top of each new file.
  */
 class FileSink : public Sink
 {
@@ -58,9 +66,92 @@ public:
      */
     std::string getAbsoluteFilepath() const { return _absoluteFilepath; }
 
+    /// @return The rotation policy of the sink.
+    [[nodiscard]] const sink::RotationPolicy& getRotationPolicy() const { return _rotationPolicy; }
+
+    /**
+     * @brief   Sets when the file is rotated, and what happens to rotated
+     *          files.
+     *
+     * The active file always keeps its path. Rotated files are renamed after
+     * their rotation time, compressed and deleted (as set by the policy) on a
+     * background thread. The next file is opened ahead of time by that
+     * thread, as @code <file>.next@endcode.
+     *
+     * Rotation happens between batches, hence a file may exceed
+     * @code maxBytes@endcode by the size of the batch that reached it.
+     *
+     * @code
+     * auto sink = std::make_shared<logger::LogFileSink>("app.log");
+     *
+     * sink->setRotationPolicy({ .maxBytes = 64 * 1024 * 1024, .isDaily = true, .maxFiles = 10 });
+     * @endcode
+     *
+     * @warning Must be called before the sink starts receiving logs.
+     */
+    void setRotationPolicy(const sink::RotationPolicy& policy);
+
 protected:
+    /**
+     * @brief   Writes to the file, keeping track of its size.
+     */
+    void writeToFile(std::string_view data);
+
+    /**
+     * @brief   Writes the beginning of a file, that is written again at the
+     *          top of each new file after a rotation.
+     */
+    void writeFileHeader(std::string_view data);
+
+    /**
+     * @brief   Moves the write position back from the end of the file
+     *          (e.g. to overwrite a footer), keeping track of its size.
+     */
+    void seekFileBack(std::streamoff count);
+
+    /**
+     * @brief   Rotates the file if the rotation policy says so.
+     *
+     * To be called by derived sinks before writing a batch, so that a batch
+     * is never split across two files.
+     */
+    void rotateIfNeeded();
+
+    /**
+     * @brief   Called before the active file is closed for a rotation, e.g.
+     *          to complete a document.
+     */
+    virtual void onFileClosing() {}
+
+    /**
+     * @brief   Called once a new file is opened and its header written, e.g.
+     *          to forget what the previous file defined.
+     */
+    virtual void onFileRotated() {}
+
     std::fstream _file;
     const std::string _absoluteFilepath;
+    std::ios::openmode _openMode = std::ios::in | std::ios::out | std::ios::trunc;
+
+private:
+    /**
+     * @brief   Closes the active file, renames it, and continues in a new
+     *          one.
+     */
+    void rotate();
+
+    /**
+     * @brief   Starts counting the age of a new file.
+     */
+    void resetDeadlines();
+
+    const std::string _extension;
+    std::string _header;
+    std::size_t _fileSize = 0;
+    sink::RotationPolicy _rotationPolicy;
+    std::unique_ptr<FileRotator> _rotator;
+    std::chrono::steady_clock::time_point _ageDeadline;
+    std::chrono::system_clock::time_point _dailyDeadline;
 };
 
 }
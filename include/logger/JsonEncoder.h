@@ -0,0 +1,98 @@
+#ifndef SHUVLOG_JSONENCODER_H
+#define SHUVLOG_JSONENCODER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BuildInfo.h"
+#include "Callsite.h"
+#include "Level.h"
+#include "Log.h"
+#include "LogFields.h"
+#include "Sink.h"
+#include "Timestamp.h"
+
+/**
+ * @brief   JSON serialization shared by the JSON sinks (and the decoder).
+ *
+ * Everything appends to a caller-owned @code std::string@endcode, that is
+ * meant to be reused from one batch to the next.
+ */
+namespace logger::json
+{
+
+    /**
+     * @brief   Appends a string escaped for JSON, without the surrounding
+     *          quotes.
+     *
+     * Quotes, backslashes and control characters are escaped, everything
+     * else (including UTF-8 sequences) is copied as is.
+     * Input is scanned 16 or 32 bytes at a time when SSE2 or AVX2 is
+     * available, so that only the bytes that need escaping are handled one
+     * by one.
+     *
+     * @param   out     Buffer to append to
+     * @param   value   Raw string
+     */
+    void appendEscaped(std::string& out, std::string_view value);
+
+    /**
+     * @brief   Appends a quoted and escaped JSON string.
+     */
+    inline void appendString(std::string& out, const std::string_view value)
+    {
+        out += '"';
+        appendEscaped(out, value);
+        out += '"';
+    }
+
+    /**
+     * @brief   Appends a log entry as a single-line JSON object.
+     *
+     * @param   out                 Buffer to append to
+     * @param   log                 Fields of the log entry
+     * @param   timestampRenderer   Renderer of the timestamp, owned by the caller
+     */
+    void appendLog(std::string& out, const LogFields& log, TimestampRenderer& timestampRenderer);
+
+    /**
+     * @brief   Same as above, straight from a log entry.
+     */
+    void appendLog(std::string& out, const Log& log, TimestampRenderer& timestampRenderer);
+
+    /**
+     * @brief   Same as above, the source members being rendered once per call
+     *          site.
+     *
+     * @param   sources Source members of the call sites rendered so far
+     */
+    void appendLog(
+        std::string& out,
+        const Log& log,
+        TimestampRenderer& timestampRenderer,
+        CallsiteCache& sources
+    );
+
+    /**
+     * @brief   Appends the members shared by the headers of the JSON sinks,
+     *          without the surrounding braces.
+     *
+     * @param   levelMask   Displayed level mask: a single level, a list of
+     *                      levels (if @code filterMode@endcode is explicit),
+     *                      or nothing
+     */
+    void appendHeaderFields(
+        std::string& out,
+        const std::string& projectName,
+        int argc,
+        const char* argv[],
+        const BuildInfo& buildInfo,
+        sink::FilterMode filterMode,
+        const std::vector<Level>& levelMask
+    );
+
+}
+
+#endif //SHUVLOG_JSONENCODER_H
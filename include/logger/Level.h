@@ -2,12 +2,40 @@
 #define SHUVLOG_LEVEL_H
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <bit>
 
 #include "Colors.h"
 
+/**
+ * Preprocessor counterparts of @code logger::Level@endcode, used to strip
+ * logging call sites at compile time (see @code SHUVLOG_ACTIVE_LEVEL@endcode).
+ */
+#define SHUVLOG_LEVEL_DEBUG     (1 << 0)
+#define SHUVLOG_LEVEL_TRACE_R3  (1 << 1)
+#define SHUVLOG_LEVEL_TRACE_R2  (1 << 2)
+#define SHUVLOG_LEVEL_TRACE_R1  (1 << 3)
+#define SHUVLOG_LEVEL_INFO      (1 << 4)
+#define SHUVLOG_LEVEL_WARNING   (1 << 5)
+#define SHUVLOG_LEVEL_ERROR     (1 << 6)
+#define SHUVLOG_LEVEL_CRITICAL  (1 << 7)
+#define SHUVLOG_LEVEL_FATAL     (1 << 8)
+
+/**
+ * Lowest level whose @code LOG_*@endcode macros are compiled in.
+ * Call sites below that level compile to nothing: their arguments are not
+ * even evaluated.
+ *
+ * Set through the @code SHUVLOG_ACTIVE_LEVEL@endcode CMake cache variable
+ * (e.g. @code -DSHUVLOG_ACTIVE_LEVEL=INFO@endcode). Defaults to
+ * @code SHUVLOG_LEVEL_DEBUG@endcode (nothing is stripped).
+ */
+#ifndef SHUVLOG_ACTIVE_LEVEL
+#define SHUVLOG_ACTIVE_LEVEL SHUVLOG_LEVEL_DEBUG
+#endif
+
 namespace logger
 {
 
@@ -24,6 +52,9 @@ enum class Level : uint16_t
     kFatal      = 1 << 8,
 };
 
+static_assert(static_cast<uint16_t>(Level::kDebug) == SHUVLOG_LEVEL_DEBUG);
+static_assert(static_cast<uint16_t>(Level::kFatal) == SHUVLOG_LEVEL_FATAL);
+
 inline uint16_t operator|(Level a, Level b)
 {
     return static_cast<uint16_t>(a) | static_cast<uint16_t>(b);
@@ -37,6 +68,21 @@ inline uint16_t operator|(uint16_t a, Level b)
 namespace level
 {
 
+    /// Number of levels in @code logger::Level@endcode.
+    inline constexpr std::size_t kCount = 9;
+
+    /**
+     * @brief   Converts a level to a dense index, to use levels as array
+     *          indices.
+     *
+     * @param   level   Logging severity level
+     * @return  An index in @code [0, kCount)@endcode
+     */
+    constexpr std::size_t toIndex(Level level)
+    {
+        return static_cast<std::size_t>(std::countr_zero(static_cast<uint16_t>(level)));
+    }
+
     /**
      * @brief   Converts a level to a string.
      *
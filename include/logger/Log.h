@@ -1,11 +1,17 @@
 #ifndef SHUVLOG_LOG_H
 #define SHUVLOG_LOG_H
 
-#include <thread>
+#include <algorithm>
 #include <chrono>
-#include <source_location>
+#include <cstdint>
+#include <string_view>
+#include <thread>
 
+#include "Callsite.h"
+#include "DeferredMessage.h"
 #include "Level.h"
+#include "LogArena.h"
+#include "ThreadRegistry.h"
 
 /**
  * @class   Log
@@ -16,48 +22,184 @@
  * about one log event.
  * It contains:
  *   - The log message
- *   - The severity level (@code logger::Level@endcode)
- *   - Source code metadata such as file, line number, and function obtained from
- *     @code std::source_location@endcode
+ *   - Its call site (@code logger::Callsite@endcode): severity level, and
+ *     source code metadata such as file, line number, and function
  *   - Thread information (ID and user-defined thread label)
- *   - A timestamp captured at construction time
+ *   - A timestamp captured at construction time, as raw ticks of the
+ *     configured @code logger::ClockSource@endcode
  *
  * This class captures all contextual information during class construction.
+ *
+ * The record is laid out to fit in two cache lines: messages up to
+ * @code kInlineCapacity@endcode bytes are stored inline, and only longer
+ * ones are allocated, from the given @code logger::LogArena@endcode when there
+ * is one (and from the heap otherwise). The thread is kept as its index in
+ * the @code logger::ThreadRegistry@endcode, which holds its label and
+ * pre-rendered id, and the call site as a pointer to its static descriptor.
+ * Accessors return views on the record, so sinks don't copy anything either.
+ *
+ * When built from a @code logger::DeferredMessage@endcode, the message text is
+ * only produced when @code resolveMessage()@endcode is called, which the
+ * Logger does on its worker thread before handing the log to the sinks.
  */
-class Log final
+class alignas(64) Log final
 {
+    enum class Storage : uint8_t
+    {
+        kInline,
+        kHeap,
+        kArena,
+        kDeferred,
+    };
+
+    static constexpr std::size_t kMetadataSize =
+        sizeof(uint64_t)
+        + sizeof(const logger::Callsite*)
+        + sizeof(uint32_t)
+        + sizeof(uint32_t)
+        + sizeof(uint32_t)
+        + sizeof(Storage);
+
 public:
+    /// Longest message stored without any allocation.
+    static constexpr std::size_t kInlineCapacity = std::max(
+        (2 * 64 - kMetadataSize) / alignof(void*) * alignof(void*),
+        sizeof(logger::DeferredMessage)
+    );
+
+    /**
+     * @param   arena       Arena to store the message in, if it doesn't fit
+     *                      inline
+     * @param   sampleRate  Number of logs this one stands for, when sampled
+     *                      (see @code LOG_INFO_SAMPLED()@endcode)
+     */
+    Log(
+        std::string_view message,
+        const logger::Callsite& site,
+        logger::LogArena* arena = nullptr,
+        uint32_t sampleRate = 1
+    );
+
+    Log(
+        logger::DeferredMessage message,
+        const logger::Callsite& site,
+        uint32_t sampleRate = 1
+    );
+
+    /**
+     * @brief   Rebuilds a log captured earlier (e.g. kept by a
+     *          @code logger::RingBufferSink@endcode), with its original
+     *          timestamp and thread.
+     *
+     * @param   timestamp   Raw ticks, as returned by @code getRawTimestamp()@endcode
+     * @param   threadIndex As returned by @code getThreadIndex()@endcode
+     * @param   sampleRate  As returned by @code getSampleRate()@endcode
+     */
     Log(
-        std::string message,
-        logger::Level level,
-        const std::source_location& loc
+        std::string_view message,
+        const logger::Callsite& site,
+        uint64_t timestamp,
+        uint32_t threadIndex,
+        uint32_t sampleRate
     );
 
-    /// @return The log message
-    [[nodiscard]] std::string getMessage() const { return _message; }
+    Log(const Log&) = delete;
+    Log& operator=(const Log&) = delete;
+    Log(Log&& other) noexcept;
+    Log& operator=(Log&& other) noexcept;
+    ~Log();
+
+    /**
+     * @brief   Formats the deferred message, if any. Does nothing otherwise.
+     *
+     * @param   arena   Arena to store the formatted message in, if it doesn't
+     *                  fit inline
+     */
+    void resolveMessage(logger::LogArena* arena = nullptr);
+
+    /**
+     * @return  The log message
+     * @warning Empty until @code resolveMessage()@endcode has been called on
+     *          a log built from a deferred message.
+     */
+    [[nodiscard]] std::string_view getMessage() const;
+
+    /**
+     * @return  The memory used by this log entry: the record itself, and its
+     *          message if it is stored out of line.
+     */
+    [[nodiscard]] std::size_t getFootprint() const;
 
     /// @return The severity level associated with this log entry
-    [[nodiscard]] logger::Level getLevel() const { return _level; }
+    [[nodiscard]] logger::Level getLevel() const { return _site->level; }
+
+    /// @return The call site where this log entry was generated
+    [[nodiscard]] const logger::Callsite& getCallsite() const { return *_site; }
 
-    /// @return The source location where this log entry was generated
-    [[nodiscard]] std::source_location getLocation() const { return _location; }
+    /// @return The identity of the thread that produced this log entry
+    [[nodiscard]] const logger::ThreadInfo& getThreadInfo() const
+    {
+        return logger::ThreadRegistry::getInstance().get(_threadIndex);
+    }
 
     /// @return The ID of the thread that produced this log entry
-    [[nodiscard]] std::thread::id getThreadId() const { return _threadId; }
+    [[nodiscard]] std::thread::id getThreadId() const { return getThreadInfo().id; }
 
     /// @return The name of the thread that produced this log entry
-    [[nodiscard]] std::string getThreadName() const { return _threadName; }
+    [[nodiscard]] std::string_view getThreadName() const { return getThreadInfo().label; }
 
     /// @return The timestamp representing when this log entry was constructed
-    [[nodiscard]] std::chrono::time_point<std::chrono::system_clock> getTimestamp() const { return _timestamp; }
+    [[nodiscard]] std::chrono::time_point<std::chrono::system_clock> getTimestamp() const;
+
+    /// @return The timestamp, as raw ticks of the clock (see @code logger::clock::now()@endcode)
+    [[nodiscard]] uint64_t getRawTimestamp() const { return _timestamp; }
+
+    /// @return The index of the thread that produced this log entry in the @code logger::ThreadRegistry@endcode
+    [[nodiscard]] uint32_t getThreadIndex() const { return _threadIndex; }
+
+    /// @return The number of logs this one stands for: N if it was sampled 1 in N, 1 otherwise
+    [[nodiscard]] uint32_t getSampleRate() const { return _sampleRate; }
 
 private:
-    std::string _message;
-    logger::Level _level;
-    std::source_location _location;
-    std::thread::id _threadId;
-    std::string _threadName;
-    std::chrono::time_point<std::chrono::system_clock> _timestamp;
+    /**
+     * @brief   Copies a message into the record, inline if it fits.
+     */
+    void storeMessage(std::string_view message, logger::LogArena* arena);
+
+    /**
+     * @brief   Releases the message, whatever its storage.
+     */
+    void releaseMessage();
+
+    /**
+     * @brief   Takes ownership of another log's message and metadata.
+     *
+     * @warning This log must not own any message.
+     */
+    void moveFrom(Log& other) noexcept;
+
+    union Payload
+    {
+        Payload() {}
+        ~Payload() {}
+
+        char text[kInlineCapacity];
+        char* heap;
+        logger::DeferredMessage deferred;
+    };
+
+    // payload first, so that its alignment doesn't cost any padding.
+    Payload _payload;
+    uint64_t _timestamp = 0; // raw ticks, see logger::clock::now()
+    const logger::Callsite* _site = nullptr;
+    uint32_t _messageSize = 0;
+    uint32_t _threadIndex = 0;
+    uint32_t _sampleRate = 1;
+    Storage _storage = Storage::kInline;
 };
 
+// logs fill exactly two cache lines, that no other log shares.
+static_assert(sizeof(Log) == 2 * 64);
+static_assert(alignof(Log) == 64);
+
 #endif //SHUVLOG_LOG_H
@@ -0,0 +1,98 @@
+#ifndef SHUVLOG_LOGARENA_H
+#define SHUVLOG_LOGARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace logger
+{
+
+/**
+ * @class   LogArena
+ * @brief   Slab allocator for the variable-length parts of log records
+ *          (messages that don't fit inline in a @code Log@endcode).
+ *
+ * Each producer thread bump-allocates from its own slab, without any
+ * synchronization. When a slab is full, the thread retires it and takes a
+ * recycled one from the arena (the only time it takes a lock, once every
+ * @code kSlabSize@endcode bytes).
+ *
+ * Allocations are never freed one by one: @code release()@endcode only
+ * counts them, and once every allocation of a retired slab has been released
+ * (which happens on the worker thread, when a batch is cleared after
+ * @code flushBatch()@endcode), the whole slab goes back to the arena to be
+ * reused. In steady state, logging doesn't allocate nor free any heap memory,
+ * and doesn't contend with the application on the global allocator.
+ *
+ * Slabs still in use when the arena is destroyed (e.g. by threads outliving
+ * the Logger) are freed by whoever releases them last.
+ */
+class LogArena final
+{
+public:
+    /// Size (and alignment) of a slab, header included.
+    static constexpr std::size_t kSlabSize = 64 * 1024;
+
+    /// Bigger allocations are left to the global allocator.
+    static constexpr std::size_t kMaxAllocation = kSlabSize / 4;
+
+    LogArena();
+    LogArena(const LogArena&) = delete;
+    LogArena& operator=(const LogArena&) = delete;
+    ~LogArena();
+
+    /**
+     * @brief   Reserves memory from the calling thread's slab.
+     *
+     * @param   size    Number of bytes to reserve
+     * @return  The reserved memory (aligned on @code alignof(void*)@endcode),
+     *          or @code nullptr@endcode if @code size@endcode exceeds
+     *          @code kMaxAllocation@endcode.
+     */
+    void* allocate(std::size_t size);
+
+    /**
+     * @brief   Releases memory previously returned by @code allocate()@endcode.
+     *
+     * Can be called from any thread. The memory is not reused right away:
+     * its slab is recycled once all of its allocations have been released.
+     *
+     * @param   ptr Memory to release
+     */
+    static void release(void* ptr);
+
+    /**
+     * @return  The number of slabs allocated so far (in use or recycled).
+     */
+    std::size_t getSlabCount() const;
+
+private:
+    struct Slab;
+    struct Cursor;
+    struct Pool;
+
+    /**
+     * @return  A recycled slab, or a new one if none is available.
+     */
+    Slab* acquireSlab();
+
+    /**
+     * @brief   Puts a slab whose allocations have all been released back in
+     *          the free list, or frees it if the arena is gone.
+     */
+    static void recycle(Slab* slab);
+
+    /**
+     * @brief   Stops allocating from a slab. It will be recycled as soon as
+     *          its @code allocated@endcode allocations have been released.
+     */
+    static void retire(Slab* slab, std::int64_t allocated);
+
+    // shared with the slabs in use, that keep it alive past the arena.
+    Pool* _pool;
+};
+
+}
+
+#endif //SHUVLOG_LOGARENA_H
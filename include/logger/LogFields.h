@@ -0,0 +1,59 @@
+#ifndef SHUVLOG_LOGFIELDS_H
+#define SHUVLOG_LOGFIELDS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "Level.h"
+#include "Log.h"
+
+namespace logger
+{
+
+/**
+ * @struct  LogFields
+ * @brief   Everything the text and JSON formats write for a log entry,
+ *          whatever it comes from (a live @code Log@endcode, or a decoded
+ *          binary record).
+ */
+struct LogFields
+{
+    std::chrono::time_point<std::chrono::system_clock> timestamp;
+    Level level;
+    std::string_view threadName;
+    std::string_view threadId;
+    std::string_view file;
+    std::string_view function;
+    uint64_t line;
+    uint64_t column;
+    std::string_view message;
+    uint32_t sampleRate = 1; ///< see @code Log::getSampleRate()@endcode
+
+    /**
+     * @return  Views on the fields of a log entry, valid as long as the log
+     *          is.
+     */
+    static LogFields from(const Log& log)
+    {
+        const ThreadInfo& thread = log.getThreadInfo();
+        const Callsite& site = log.getCallsite();
+
+        return {
+            log.getTimestamp(),
+            site.level,
+            thread.label,
+            thread.prettyId,
+            site.file,
+            site.function,
+            site.line,
+            site.column,
+            log.getMessage(),
+            log.getSampleRate(),
+        };
+    }
+};
+
+}
+
+#endif //SHUVLOG_LOGFIELDS_H
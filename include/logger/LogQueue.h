@@ -0,0 +1,269 @@
+#ifndef SHUVLOG_LOGQUEUE_H
+#define SHUVLOG_LOGQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Log.h"
+#include "MpscRingBuffer.h"
+#include "Settings.h"
+#include "SpscRingBuffer.h"
+#include "Thread.h"
+#include "ThreadSafeQueue.h"
+
+namespace logger
+{
+
+/**
+ * @class   ThreadLogBuffer
+ * @brief   Per-thread buffer used by @code QueueBackend::kPerThread@endcode.
+ *
+ * Written only by its owning thread, and read only by the worker.
+ */
+class ThreadLogBuffer final
+{
+public:
+    explicit ThreadLogBuffer(std::size_t capacity) : ring(capacity) {}
+
+    SpscRingBuffer<Log> ring;
+    /// Set by the owning thread when it exits. No log is pushed afterwards.
+    std::atomic<bool> closed{false};
+};
+
+/**
+ * @class   LogQueue
+ * @brief   Carries logs from producer threads to the Logger's worker thread.
+ *
+ * This class exposes the same interface as @code ThreadSafeQueue@endcode,
+ * and forwards every call to the backend selected through
+ * @code logger::Settings::setQueueBackend()@endcode:
+ *   - @code QueueBackend::kMutex@endcode: unbounded @code ThreadSafeQueue@endcode
+ *   - @code QueueBackend::kLockFree@endcode: bounded @code MpscRingBuffer@endcode
+ *   - @code QueueBackend::kPerThread@endcode: one bounded @code SpscRingBuffer@endcode
+ *     per producer thread, registered the first time the thread logs
+ *
+ * With the lock-free backend, producers never wait on the worker: the only
+ * time a producer touches a mutex is to wake the worker up when it is idle,
+ * which happens at most once per idle period.
+ *
+ * With the per-thread backend, @code pop()@endcode visits registered buffers
+ * in a round-robin fashion, so that a thread flooding the Logger can't starve
+ * quieter threads within a batch. Buffers of exited threads are released once
+ * they have been drained.
+ *
+ * On top of the backend's own capacity, the queue can be bounded in number of
+ * logs and in bytes (see @code logger::Settings::setMaxQueuedLogs()@endcode).
+ * Logs pushed while the queue is full are handled according to the
+ * configured @code OverflowPolicy@endcode, and dropped logs are counted per
+ * level.
+ */
+class LogQueue final
+{
+public:
+    LogQueue() = default;
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+
+    /**
+     * @brief   Selects and allocates the backend described by the settings.
+     *
+     * @warning Must be called before any producer or consumer uses the
+     *          queue.
+     *
+     * @param   settings    Global Logger settings
+     */
+    void configure(const Settings& settings);
+
+    /**
+     * @brief   Adds a log to the back of the queue.
+     *
+     * If the queue is full, the configured @code OverflowPolicy@endcode
+     * decides whether the calling thread sleeps until the worker releases
+     * some room, or whether a log is dropped.
+     *
+     * @param   log The log to push to the queue
+     */
+    void push(Log log);
+
+    /**
+     * @brief   Removes the first log of the queue.
+     *
+     * @return  The popped log, or @code std::nullopt@endcode if the queue is
+     *          empty.
+     */
+    std::optional<Log> pop();
+
+    /**
+     * @return  The number of logs in the queue.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief   Blocks until data is available, until a timeout occurs, or
+     *          until @code runningFlag@endcode becomes false.
+     *
+     * @param   timeout     The maximum time to wait, in milliseconds
+     * @param   runningFlag A flag that indicates whether the system is still active
+     */
+    void waitForData(
+        std::chrono::milliseconds timeout,
+        const std::atomic<bool>& runningFlag
+    );
+
+    /**
+     * @brief   Removes all logs from the queue and appends them to
+     *          @code out@endcode.
+     *
+     * @param   out The vector to which all queued logs will be moved
+     */
+    void drainTo(std::vector<Log>& out);
+
+    /**
+     * @brief   Wakes up the worker if it is waiting for data.
+     */
+    void notifyAll();
+
+    /**
+     * @brief   Stops blocking producers: from now on, logs pushed while the
+     *          queue is full are dropped, whatever the policy.
+     *
+     * Called when the worker is about to stop, so that nobody waits forever
+     * for room that will never be released. Producers already waiting are
+     * woken up.
+     */
+    void close();
+
+    /**
+     * @return  The number of logs of a given level dropped since the queue
+     *          was created.
+     */
+    std::uint64_t getDroppedCount(Level level) const;
+
+private:
+    /**
+     * @brief   Pushes a log to the backend, if it isn't full.
+     *
+     * @return  @code false@endcode if the backend is full. In that case,
+     *          @code log@endcode is left untouched.
+     */
+    bool tryPush(Log& log);
+
+    /**
+     * @brief   Pops a log from the backend, without any accounting.
+     */
+    std::optional<Log> popFromBackend();
+
+    /**
+     * @brief   Handles a log that doesn't fit in the queue.
+     *
+     * @param   roomVersion Version of the released room seen before the
+     *                      last attempt, set once the producer has announced
+     *                      that it waits for room
+     * @return  @code true@endcode if the push must be retried,
+     *          @code false@endcode if the log has been dropped.
+     */
+    bool handleOverflow(const Log& log, std::optional<std::uint64_t>& roomVersion);
+
+    /**
+     * @brief   Sleeps until the consumer releases some room after
+     *          @code roomVersion@endcode, or until the queue is closed.
+     *
+     * @return  The current version of the released room.
+     */
+    std::uint64_t waitForRoom(std::uint64_t roomVersion);
+
+    /**
+     * @brief   Wakes producers up if some announced that they wait for room.
+     */
+    void releaseRoom();
+
+    /**
+     * @brief   Reserves room for a log in the configured bounds.
+     *
+     * @return  @code false@endcode if the log doesn't fit.
+     */
+    bool reserve(std::size_t footprint);
+
+    /**
+     * @brief   Gives back room reserved for a log.
+     */
+    void unreserve(std::size_t footprint);
+
+    /**
+     * @brief   Counts a dropped log.
+     */
+    void recordDrop(Level level);
+    /**
+     * @brief   Wakes the worker up if it announced that it is going to sleep.
+     */
+    void wakeConsumer();
+
+    /**
+     * @return  The calling thread's buffer, registering it if needed.
+     */
+    ThreadLogBuffer& localBuffer();
+
+    /**
+     * @brief   Pops the next log of the per-thread backend, visiting buffers
+     *          in a round-robin fashion.
+     */
+    std::optional<Log> popFromThreadBuffers();
+
+    /**
+     * @brief   Releases the buffers of exited threads that have been fully
+     *          drained. Consumer side only.
+     */
+    void releaseClosedBuffers();
+
+    /**
+     * @return  @code true@endcode if at least one log is waiting in the
+     *          bounded backends.
+     */
+    bool hasData();
+
+    QueueBackend _backend = QueueBackend::kMutex;
+    OverflowPolicy _overflowPolicy = OverflowPolicy::kBlock;
+    ThreadSafeQueue<Log> _lockedQueue;
+    std::unique_ptr<MpscRingBuffer<Log>> _ringBuffer;
+
+    // per-thread backend
+    std::size_t _threadBufferCapacity = 0;
+    mutable std::mutex _threadBuffersMutex;
+    std::vector<std::unique_ptr<ThreadLogBuffer>> _threadBuffers;
+    std::atomic<std::uint64_t> _threadBuffersVersion{0};
+
+    // consumer-side snapshot of _threadBuffers, only touched by the worker
+    std::vector<ThreadLogBuffer*> _drainOrder;
+    std::uint64_t _drainVersion = 0;
+    std::size_t _drainCursor = 0;
+
+    // bounds on top of the backend's capacity, only tracked when configured
+    bool _isBounded = false;
+    std::size_t _maxLogs = 0;
+    std::size_t _maxBytes = 0;
+    std::atomic<std::size_t> _queuedLogs{0};
+    std::atomic<std::size_t> _queuedBytes{0};
+    std::atomic<bool> _isClosed{false};
+    std::array<std::atomic<std::uint64_t>, level::kCount> _dropped{};
+
+    // idle handshake for lock-free backends
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCvar;
+    std::atomic<bool> _consumerWaiting{false};
+
+    // handshake for producers blocked on a full queue
+    std::mutex _roomMutex;
+    std::condition_variable _roomCvar;
+    std::atomic<std::uint32_t> _roomWaiters{0};
+    std::atomic<std::uint64_t> _roomVersion{0};
+};
+
+}
+
+#endif //SHUVLOG_LOGQUEUE_H
@@ -1,6 +1,9 @@
 #ifndef SHUVLOG_LOGGER_H
 #define SHUVLOG_LOGGER_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <source_location>
@@ -8,26 +11,196 @@
 #include <thread>
 
 #include "BuildInfo.h"
+#include "Callsite.h"
+#include "CallsiteLimiter.h"
+#include "CallsiteRegistry.h"
 #include "FileSink.h"
 #include "Exceptions/LoggerException.h"
 #include "Level.h"
 #include "Log.h"
+#include "Sampling.h"
+#include "LogArena.h"
+#include "LogQueue.h"
+#include "RenderCache.h"
 #include "Settings.h"
 #include "Sink.h"
-#include "ThreadSafeQueue.h"
+#include "SinkRegistry.h"
+#include "SinkWorker.h"
 #include "Exceptions/DuplicateSink.h"
 #include "Sinks/ConsoleSink.h"
 
+namespace logger::detail
+{
+
+    /**
+     * @brief   Never defined: only used in unevaluated contexts, so that
+     *          stripped call sites still type-check their arguments (and
+     *          count as uses of them) without generating any code.
+     */
+    template<typename... Args>
+    int discard(Args&&... args);
+
+}
+
 #define CUR_SOURCE          std::source_location::current()
-#define LOG_DEBUG(...)      Logger::getInstance().log(logger::Level::kDebug,    CUR_SOURCE, __VA_ARGS__)
-#define LOG_TRACE_R3(...)   Logger::getInstance().log(logger::Level::kTraceR3,  CUR_SOURCE, __VA_ARGS__)
-#define LOG_TRACE_R2(...)   Logger::getInstance().log(logger::Level::kTraceR2,  CUR_SOURCE, __VA_ARGS__)
-#define LOG_TRACE_R1(...)   Logger::getInstance().log(logger::Level::kTraceR1,  CUR_SOURCE, __VA_ARGS__)
-#define LOG_INFO(...)       Logger::getInstance().log(logger::Level::kInfo,     CUR_SOURCE, __VA_ARGS__)
-#define LOG_WARN(...)       Logger::getInstance().log(logger::Level::kWarning,  CUR_SOURCE, __VA_ARGS__)
-#define LOG_ERR(...)        Logger::getInstance().log(logger::Level::kError,    CUR_SOURCE, __VA_ARGS__)
-#define LOG_CRIT(...)       Logger::getInstance().log(logger::Level::kCritical, CUR_SOURCE, __VA_ARGS__)
-#define LOG_FATAL(...)      Logger::getInstance().log(logger::Level::kFatal,    CUR_SOURCE, __VA_ARGS__)
+#define SHUVLOG_STRIPPED(...) static_cast<void>(sizeof(logger::detail::discard(__VA_ARGS__)))
+
+/**
+ * Call site of the macro expansion, registered on its first evaluation (see
+ * @code logger::CallsiteRegistry@endcode).
+ */
+#define SHUVLOG_CALLSITE(level)                                             \
+    [](const std::source_location shuvlogLoc) -> const logger::Callsite& {  \
+        static constinit std::atomic<bool> shuvlogIsEnabled{ true };        \
+        static const logger::Callsite& shuvlogSite =                        \
+            logger::CallsiteRegistry::getInstance().add(level, shuvlogLoc, shuvlogIsEnabled); \
+        return shuvlogSite;                                                 \
+    }(std::source_location::current())
+
+/**
+ * Each expansion has its own enabled flag, checked first: a call site turned
+ * off through the @code logger::CallsiteRegistry@endcode costs a single
+ * relaxed atomic load. It is registered the first time it's reached with its
+ * level enabled, which may turn it off right away.
+ */
+#define SHUVLOG_LOG(level, ...)                                             \
+    [&](const std::source_location shuvlogLoc) {                            \
+        static constinit std::atomic<bool> shuvlogIsEnabled{ true };        \
+        if (shuvlogIsEnabled.load(std::memory_order_relaxed)                \
+            && Logger::getInstance().isLevelEnabled(level)) {               \
+            static const logger::Callsite& shuvlogSite =                    \
+                logger::CallsiteRegistry::getInstance().add(level, shuvlogLoc, shuvlogIsEnabled); \
+            if (shuvlogSite.isEnabled()) {                                  \
+                Logger::getInstance().log(shuvlogSite, __VA_ARGS__);        \
+            }                                                               \
+        }                                                                   \
+    }(std::source_location::current())
+
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)      SHUVLOG_LOG(logger::Level::kDebug,    __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)      SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_TRACE_R3
+#define LOG_TRACE_R3(...)   SHUVLOG_LOG(logger::Level::kTraceR3,  __VA_ARGS__)
+#else
+#define LOG_TRACE_R3(...)   SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_TRACE_R2
+#define LOG_TRACE_R2(...)   SHUVLOG_LOG(logger::Level::kTraceR2,  __VA_ARGS__)
+#else
+#define LOG_TRACE_R2(...)   SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_TRACE_R1
+#define LOG_TRACE_R1(...)   SHUVLOG_LOG(logger::Level::kTraceR1,  __VA_ARGS__)
+#else
+#define LOG_TRACE_R1(...)   SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_INFO
+#define LOG_INFO(...)       SHUVLOG_LOG(logger::Level::kInfo,     __VA_ARGS__)
+#else
+#define LOG_INFO(...)       SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_WARNING
+#define LOG_WARN(...)       SHUVLOG_LOG(logger::Level::kWarning,  __VA_ARGS__)
+#else
+#define LOG_WARN(...)       SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_ERROR
+#define LOG_ERR(...)        SHUVLOG_LOG(logger::Level::kError,    __VA_ARGS__)
+#else
+#define LOG_ERR(...)        SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_CRITICAL
+#define LOG_CRIT(...)       SHUVLOG_LOG(logger::Level::kCritical, __VA_ARGS__)
+#else
+#define LOG_CRIT(...)       SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_FATAL
+#define LOG_FATAL(...)      SHUVLOG_LOG(logger::Level::kFatal,    __VA_ARGS__)
+#else
+#define LOG_FATAL(...)      SHUVLOG_STRIPPED(__VA_ARGS__)
+#endif
+
+/**
+ * Sampled logs: only 1 in N calls of a call site is kept (the first one,
+ * then every N-th), or each call is kept with a given probability when
+ * passing a @code logger::Probability@endcode. Calls that aren't kept cost an
+ * atomic increment (or a per-thread random number), and neither their
+ * arguments nor their message are evaluated.
+ * Kept logs record their sample rate (@code Log::getSampleRate()@endcode),
+ * that structured sinks write for downstream re-weighting.
+ *
+ * @code
+ * LOG_INFO_SAMPLED(1000, "request {} served in {} us", id, duration);
+ * @endcode
+ *
+ * @note    The rate is evaluated once per call, and not at all while the
+ *          call site or its level is disabled.
+ */
+#define SHUVLOG_LOG_SAMPLED(level, rate, ...)                               \
+    [&](const std::source_location shuvlogLoc) {                            \
+        static constinit std::atomic<bool> shuvlogIsEnabled{ true };        \
+        if (!shuvlogIsEnabled.load(std::memory_order_relaxed)               \
+            || !Logger::getInstance().isLevelEnabled(level)) {              \
+            return;                                                         \
+        }                                                                   \
+        const auto shuvlogRate = (rate);                                    \
+        if (logger::detail::isSampled<decltype([] {})>(shuvlogRate)) {      \
+            static const logger::Callsite& shuvlogSite =                    \
+                logger::CallsiteRegistry::getInstance().add(level, shuvlogLoc, shuvlogIsEnabled); \
+            if (shuvlogSite.isEnabled()) {                                  \
+                Logger::getInstance().logSampled(                           \
+                    shuvlogSite, logger::detail::toSampleRate(shuvlogRate), __VA_ARGS__); \
+            }                                                               \
+        }                                                                   \
+    }(std::source_location::current())
+
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_DEBUG
+#define LOG_DEBUG_SAMPLED(rate, ...)          SHUVLOG_LOG_SAMPLED(logger::Level::kDebug,     rate, __VA_ARGS__)
+#else
+#define LOG_DEBUG_SAMPLED(rate, ...)          SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_TRACE_R3
+#define LOG_TRACE_R3_SAMPLED(rate, ...)       SHUVLOG_LOG_SAMPLED(logger::Level::kTraceR3,   rate, __VA_ARGS__)
+#else
+#define LOG_TRACE_R3_SAMPLED(rate, ...)       SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_TRACE_R2
+#define LOG_TRACE_R2_SAMPLED(rate, ...)       SHUVLOG_LOG_SAMPLED(logger::Level::kTraceR2,   rate, __VA_ARGS__)
+#else
+#define LOG_TRACE_R2_SAMPLED(rate, ...)       SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_TRACE_R1
+#define LOG_TRACE_R1_SAMPLED(rate, ...)       SHUVLOG_LOG_SAMPLED(logger::Level::kTraceR1,   rate, __VA_ARGS__)
+#else
+#define LOG_TRACE_R1_SAMPLED(rate, ...)       SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_INFO
+#define LOG_INFO_SAMPLED(rate, ...)           SHUVLOG_LOG_SAMPLED(logger::Level::kInfo,      rate, __VA_ARGS__)
+#else
+#define LOG_INFO_SAMPLED(rate, ...)           SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_WARNING
+#define LOG_WARN_SAMPLED(rate, ...)           SHUVLOG_LOG_SAMPLED(logger::Level::kWarning,   rate, __VA_ARGS__)
+#else
+#define LOG_WARN_SAMPLED(rate, ...)           SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_ERROR
+#define LOG_ERR_SAMPLED(rate, ...)            SHUVLOG_LOG_SAMPLED(logger::Level::kError,     rate, __VA_ARGS__)
+#else
+#define LOG_ERR_SAMPLED(rate, ...)            SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_CRITICAL
+#define LOG_CRIT_SAMPLED(rate, ...)           SHUVLOG_LOG_SAMPLED(logger::Level::kCritical,  rate, __VA_ARGS__)
+#else
+#define LOG_CRIT_SAMPLED(rate, ...)           SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
+#if SHUVLOG_ACTIVE_LEVEL <= SHUVLOG_LEVEL_FATAL
+#define LOG_FATAL_SAMPLED(rate, ...)          SHUVLOG_LOG_SAMPLED(logger::Level::kFatal,     rate, __VA_ARGS__)
+#else
+#define LOG_FATAL_SAMPLED(rate, ...)          SHUVLOG_STRIPPED(rate, __VA_ARGS__)
+#endif
 
 /**
  * @class   Logger
@@ -43,8 +216,8 @@
  *
  * Each call to @code log()@endcode creates a Log entry and, consequently, records:
  *   - The formatted text message
- *   - The severity level
- *   - A @code std::source_location@endcode describing file, function, and line
+ *   - Its call site (@code logger::Callsite@endcode): severity level, file,
+ *     function, and line
  *   - Thread ID and user-defined thread label
  *   - A timestamp
  *
@@ -59,13 +232,19 @@
  * (@code std::cerr@endcode).
  *
  * @section macros  Convenience Macros
- * The following macros automatically provide the level and source location:
+ * The following macros automatically provide the call site (level and
+ * source location), created once per macro expansion:
  *   - @code LOG_DEBUG(...)@endcode
  *   - @code LOG_INFO(...)@endcode
  *   - @code LOG_WARN(...)@endcode
  *   - @code LOG_ERR(...)@endcode
  *   - @code LOG_CRIT(...)@endcode
  *   - @code LOG_FATAL(...)@endcode
+ *
+ * Macros whose level is below @code SHUVLOG_ACTIVE_LEVEL@endcode are stripped
+ * at compile time: they generate no code, and their arguments are never
+ * evaluated. The others can be turned on and off at runtime, one by one
+ * (see @code getCallsiteRegistry()@endcode).
  */
 class Logger final
 {
@@ -118,9 +297,11 @@ public:
      * @tparam  T       Class of the Sink to attach. T must inherit from
      *                  @code logger::Sink@endcode.
      * @param   args    Arguments that the Sink class takes as parameters
+     * @return  The attached Sink, or @code nullptr@endcode if it could not
+     *          be attached.
      */
     template<typename T, typename... Args>
-    void addSink(Args... args)
+    std::shared_ptr<T> addSink(Args... args)
     {
         static_assert(
             std::is_base_of_v<logger::Sink, T>,
@@ -130,18 +311,18 @@ public:
         try {
             constexpr bool isConsoleSink = std::is_same_v<T, logger::ConsoleSink>;
 
+            auto sink = std::make_shared<T>(std::forward<Args>(args)...);
+            std::lock_guard lock(_sinkMutex);
+
             if (isConsoleSink && _hasConsoleSink) {
                 throw logger::exception::DuplicateSink("CONSOLE");
             }
 
-            auto sink = std::make_shared<T>(std::forward<Args>(args)...);
-            std::lock_guard lock(_sinkMutex);
-
             if constexpr (std::is_base_of_v<logger::FileSink, T>) {
                 auto newFilepath = sink->getAbsoluteFilepath();
 
-                for (const auto& s : _sinks) {
-                    if (const auto fileSink = std::dynamic_pointer_cast<logger::FileSink>(s)) {
+                for (const auto& entry : _sinkRegistry.current().entries) {
+                    if (const auto fileSink = std::dynamic_pointer_cast<logger::FileSink>(entry.sink)) {
                         const std::string sinkFilepath = fileSink->getAbsoluteFilepath();
 
                         if (sinkFilepath != newFilepath) {
@@ -162,20 +343,100 @@ public:
                 );
             }
 
-            _sinks.push_back(std::move(sink));
+            attachSink(sink);
 
             if (isConsoleSink) {
                 _hasConsoleSink = true;
             }
+            return sink;
         } catch (const logger::exception::LoggerException& e) {
             const std::string error = std::format("Encountered an error while adding Sink: {}", e.what());
 
-            if (_isInitialized && !_sinks.empty()) {
-                LOG_WARN(error);
+            if (_isInitialized && !_sinkRegistry.empty()) {
+                log(logger::Level::kWarning, CUR_SOURCE, error);
             } else {
                 std::cerr << error << std::endl;
             }
         }
+        return nullptr;
+    }
+
+    /**
+     * @brief   Detaches a Sink from the Logger.
+     *
+     * Once this function returns, the Sink won't be written anymore: it is
+     * flushed and closed. Logs already handed to the Sink's own thread (if
+     * any) are written first.
+     *
+     * Can be called at any time, even while other threads are logging.
+     *
+     * @warning Can't be called by a Sink while it writes (nor by the thread
+     *          writing to it): it would wait for itself to be done with the
+     *          Sink. Nothing is detached then, and it returns
+     *          @code false@endcode.
+     *
+     * @param   sink    Sink to detach, as returned by @code addSink()@endcode
+     * @return  @code false@endcode if the Sink wasn't attached, or if called
+     *          from the thread writing to it.
+     */
+    bool removeSink(const std::shared_ptr<logger::Sink>& sink);
+
+    /**
+     * @brief   Changes the level filter of an attached Sink.
+     *
+     * Unlike @code logger::Sink::setFilter()@endcode, this also updates the
+     * set of levels the Logger lets through (see @code isLevelEnabled()@endcode).
+     *
+     * @param   sink        Sink to update, as returned by @code addSink()@endcode
+     * @param   filterMode  Filtering mode to use
+     * @param   levelMask   Level specification
+     *                      (see @code logger::Sink@endcode constructor)
+     *
+     * @throws  logger::exception::InvalidLevel if kMinimumLevel mode receives OR'd levels
+     */
+    void setSinkFilter(
+        const std::shared_ptr<logger::Sink>& sink,
+        logger::sink::FilterMode filterMode,
+        uint16_t levelMask
+    );
+
+    /**
+     * @brief   Tells how far behind the Logger a Sink is, when each Sink runs
+     *          on its own thread (see @code logger::Settings::setThreadPerSink()@endcode).
+     *
+     * @param   sink    Attached Sink, as returned by @code addSink()@endcode
+     * @return  The Sink's lag, all zeros if it doesn't run on its own thread.
+     */
+    [[nodiscard]] logger::sink::Lag getSinkLag(const std::shared_ptr<logger::Sink>& sink);
+
+    /**
+     * @brief   Checks whether at least one attached Sink accepts a level.
+     *
+     * This is a single relaxed atomic load, checked by the @code LOG_*@endcode
+     * macros and by @code log()@endcode before any formatting happens, so
+     * that logs no Sink would accept cost (almost) nothing.
+     *
+     * @note    Returns @code true@endcode for every level as long as no Sink
+     *          is attached, so that misuses keep being reported.
+     *
+     * @param   level   Level to check
+     * @return  @code true@endcode if logs of that level may be written
+     */
+    [[nodiscard]] bool isLevelEnabled(logger::Level level) const
+    {
+        return (_enabledLevels.load(std::memory_order_relaxed) & static_cast<uint16_t>(level)) != 0;
+    }
+
+    /**
+     * @brief   Number of logs of a given level dropped because the queue was
+     *          full (see @code logger::Settings::setOverflowPolicy()@endcode).
+     *
+     * @param   level   Level to check
+     * @return  The number of dropped logs since the Logger was created
+     */
+    [[nodiscard]] uint64_t getDroppedCount(logger::Level level) const
+    {
+        return _queue.getDroppedCount(level);
     }
 
     /**
@@ -185,6 +446,35 @@ public:
      * Acts the exact same way as the other @code log()@endcode function,
      * but with a format feature, that uses @code std::format@endcode.
      *
+     * If deferred formatting is enabled
+     * (@code logger::Settings::setDeferFormatting()@endcode) and every
+     * argument can be captured (@code logger::DeferredArg@endcode), the
+     * arguments are copied into the log and formatting happens on the worker
+     * thread instead.
+     *
+     * Rate limits and repeat collapsing
+     * (@code logger::Settings::setRateLimit()@endcode,
+     * @code logger::Settings::setCollapseRepeats()@endcode) are checked
+     * first, so that dropped logs are never formatted.
+     *
+     * @param   site    Call site of the log (level, file, line, function),
+     *                  see @code SHUVLOG_CALLSITE()@endcode
+     * @param   format  Format
+     * @param   args    Format arguments
+     */
+    template<typename... Args>
+    void log(
+        const logger::Callsite& site,
+        std::format_string<Args...> format,
+        Args&&... args
+    )
+    {
+        logFormatted(site, 1, format, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief   Same as above, from a level and a source location.
+     *
      * @param   level   Severity of the log message
      * @param   loc     Source information (file, line, function)
      * @param   format  Format
@@ -198,8 +488,32 @@ public:
         Args&&... args
     )
     {
-        std::string message = std::format(format, std::forward<Args>(args)...);
-        log(level, loc, std::string_view{message});
+        if (isLevelEnabled(level)) {
+            logFormatted(logger::CallsiteRegistry::getInstance().intern(level, loc), 1, format, std::forward<Args>(args)...);
+        }
+    }
+
+    /**
+     * @brief   Creates a log kept by sampling, and puts it in the queue.
+     *
+     * Acts the exact same way as the formatted @code log()@endcode
+     * function, the log recording that it stands for
+     * @code sampleRate@endcode calls (see @code LOG_INFO_SAMPLED@endcode).
+     *
+     * @param   site        Call site of the log
+     * @param   sampleRate  Number of calls the log stands for
+     * @param   format      Format
+     * @param   args        Format arguments
+     */
+    template<typename... Args>
+    void logSampled(
+        const logger::Callsite& site,
+        uint32_t sampleRate,
+        std::format_string<Args...> format,
+        Args&&... args
+    )
+    {
+        logFormatted(site, sampleRate, format, std::forward<Args>(args)...);
     }
 
     /**
@@ -207,6 +521,17 @@ public:
      *
      * @see     @class Log
      *
+     * @param   site    Call site of the log
+     * @param   message Log message
+     */
+    void log(
+        const logger::Callsite& site,
+        std::string_view message
+    );
+
+    /**
+     * @brief   Same as above, from a level and a source location.
+     *
      * @param   level   Severity of the log message
      * @param   loc     Source information (file, line, function)
      * @param   message Log message
@@ -217,6 +542,31 @@ public:
         std::string_view message
     );
 
+    /**
+     * @brief   Creates a log whose message will be formatted by the worker
+     *          thread, and puts it in the queue.
+     *
+     * @param   site    Call site of the log
+     * @param   message Format string and captured arguments
+     */
+    void log(
+        const logger::Callsite& site,
+        logger::DeferredMessage message
+    );
+
+    /**
+     * @brief   Same as above, from a level and a source location.
+     *
+     * @param   level   Severity of the log message
+     * @param   loc     Source information (file, line, function)
+     * @param   message Format string and captured arguments
+     */
+    void log(
+        logger::Level level,
+        const std::source_location& loc,
+        logger::DeferredMessage message
+    );
+
     /**
      * @brief   Shuts down the Logger.
      *
@@ -245,6 +595,14 @@ public:
         const std::string& extension
     );
 
+    /**
+     * @return  The registry that turns call sites on and off at runtime.
+     */
+    [[nodiscard]] logger::CallsiteRegistry& getCallsiteRegistry() const
+    {
+        return logger::CallsiteRegistry::getInstance();
+    }
+
     [[nodiscard]] bool isInitialized() const { return _isInitialized; }
     [[nodiscard]] logger::Settings& getSettings() { return _settings; }
 
@@ -252,12 +610,187 @@ private:
     Logger() = default;
     ~Logger();
 
+    /**
+     * @brief   Body of the formatted @code log()@endcode functions.
+     */
+    template<typename... Args>
+    void logFormatted(
+        const logger::Callsite& site,
+        uint32_t sampleRate,
+        std::format_string<Args...> format,
+        Args&&... args
+    )
+    {
+        if (!site.isEnabled() || !isLevelEnabled(site.level) || !admit(site)) {
+            return;
+        }
+
+        // repeats are told apart by their arguments when possible, without
+        // formatting anything.
+        constexpr bool isHashable = logger::CallsiteLimiter::kHashable<Args...>;
+
+        if constexpr (isHashable) {
+            if (_callsites.isCollapsing() && isRepeat(site, logger::CallsiteLimiter::hashArgs(args...))) {
+                return;
+            }
+        }
+
+        if constexpr (logger::DeferredMessage::kCapturable<Args...>) {
+            if (_settings.isFormattingDeferred()) {
+                submit(site, logger::DeferredMessage(format.get(), std::forward<Args>(args)...), sampleRate);
+                return;
+            }
+        }
+
+        // reusing a per-thread buffer: the message is copied into the log
+        // anyway, so there's no need to allocate a new string every time.
+        thread_local std::string message;
+
+        message.clear();
+        std::format_to(std::back_inserter(message), format, std::forward<Args>(args)...);
+        if constexpr (!isHashable) {
+            if (_callsites.isCollapsing() && isRepeat(site, logger::CallsiteLimiter::hashMessage(message))) {
+                return;
+            }
+        }
+        submit(site, std::string_view{message}, sampleRate);
+    }
+
+    /**
+     * @return  @code true@endcode if the Logger is ready to accept logs.
+     *          Otherwise, prints why to the standard error output.
+     */
+    bool canLog() const;
+
+    /**
+     * @brief   Publishes a new sink snapshot with an additional Sink, started
+     *          on its own thread if needed.
+     *
+     * @warning @code _sinkMutex@endcode must be held.
+     */
+    void attachSink(const std::shared_ptr<logger::Sink>& sink);
+
+    /**
+     * @brief   Recomputes the union of the levels accepted by attached sinks.
+     *
+     * @warning @code _sinkMutex@endcode must be held.
+     */
+    void updateEnabledLevels();
+
     void workerLoop();
 
-    void collectBatch(std::vector<Log>& batch);
+    /**
+     * @return  @code true@endcode if the queue has been emptied, rather than
+     *          the batch filled.
+     */
+    bool collectBatch(std::vector<Log>& batch);
     void collectRemainingLogs(std::vector<Log>& batch);
     void flushBatch(std::vector<Log>& batch);
 
+    /**
+     * @brief   Hands a resolved batch over to the sinks' own threads.
+     *          @code batch@endcode is left empty.
+     */
+    void dispatchBatch(
+        std::vector<Log>& batch,
+        const logger::SinkRegistry::Snapshot& sinks
+    );
+
+    /**
+     * @brief   Appends a "messages dropped" log to the batch if logs have been
+     *          dropped since the last report, at most once every
+     *          @code logger::Settings::getDropReportIntervalMs()@endcode
+     *          (unless @code force@endcode is set).
+     */
+    void reportDrops(std::vector<Log>& batch, bool force);
+
+    /**
+     * @brief   Frees what the @code logger::ThreadRegistry@endcode retired
+     *          before an epoch, if every log queued before it has been
+     *          written (sink threads included).
+     *
+     * @param   isDrained   Whether the queue has been emptied since the
+     *                      epoch began
+     */
+    void reclaimThreads(uint64_t epoch, bool isDrained);
+
+    /**
+     * @brief   Checks the call site's rate limit, reporting the logs it
+     *          dropped if this one gets through.
+     *
+     * @return  @code false@endcode if the log must be dropped.
+     */
+    bool admit(const logger::Callsite& site)
+    {
+        uint64_t suppressed = 0;
+
+        if (!_callsites.isLimiting()) {
+            return true;
+        }
+        if (!_callsites.admit(site, suppressed)) {
+            return false;
+        }
+        if (suppressed != 0) {
+            submit(site, std::format("{} logs suppressed by the rate limit of this call site.", suppressed));
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Checks whether a log repeats the previous one of its call
+     *          site, reporting the collapsed repeats if it doesn't.
+     *
+     * @return  @code true@endcode if the log must be dropped.
+     */
+    bool isRepeat(const logger::Callsite& site, uint64_t hash);
+
+    /**
+     * @brief   Creates a log that passed every check, and queues it (or holds
+     *          it back, see @code logger::Settings::setBacktrace()@endcode).
+     */
+    void submit(
+        const logger::Callsite& site,
+        std::string_view message,
+        uint32_t sampleRate = 1
+    );
+
+    /**
+     * @see     @code submit()@endcode
+     */
+    void submit(
+        const logger::Callsite& site,
+        logger::DeferredMessage message,
+        uint32_t sampleRate = 1
+    );
+
+    /**
+     * @return  @code true@endcode if logs of that level are held back in the
+     *          calling thread's backtrace (see
+     *          @code logger::Settings::setBacktrace()@endcode).
+     */
+    [[nodiscard]] bool isBacktraced(logger::Level level) const
+    {
+        return _settings.getBacktraceDepth() != 0
+            && static_cast<uint16_t>(level) <= static_cast<uint16_t>(_settings.getBacktraceLevel());
+    }
+
+    /**
+     * @brief   Keeps a log in the calling thread's backtrace, overwriting the
+     *          oldest one if it's full.
+     */
+    void holdBack(Log log);
+
+    /**
+     * @brief   Queues a log, preceded by the calling thread's backtrace if
+     *          its level triggers it.
+     */
+    void enqueue(Log log);
+
+    /**
+     * @brief   Recalibrates the timestamp source, at most once per second.
+     */
+    void recalibrateClock();
+
     // configuration
     logger::Settings _settings;
     std::string _projectName;
@@ -267,10 +800,21 @@ private:
 
     // runtime
     std::thread _worker;
-    ThreadSafeQueue<Log> _queue;
+    // declared before the queue, so that it outlives the logs still queued.
+    logger::LogArena _arena;
+    logger::LogQueue _queue;
+    logger::CallsiteLimiter _callsites;
 
-    std::vector<std::shared_ptr<logger::Sink>> _sinks;
+    logger::SinkRegistry _sinkRegistry;
+    logger::RenderCache _renderCache; // worker only
+    // serializes changes to the sink registry, never taken by the worker
     std::mutex _sinkMutex;
+    std::atomic<uint16_t> _enabledLevels{0xFFFF};
+
+    // worker-side drop reporting
+    std::array<uint64_t, logger::level::kCount> _reportedDrops{};
+    std::chrono::steady_clock::time_point _lastDropReport;
+    std::chrono::steady_clock::time_point _lastCalibration;
 
     std::atomic<bool> _isRunning{false};
     std::atomic<bool> _isInitialized{false};
@@ -0,0 +1,164 @@
+#ifndef SHUVLOG_MPSCRINGBUFFER_H
+#define SHUVLOG_MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+
+/**
+ * @class   MpscRingBuffer
+ * @brief   Bounded, lock-free multi-producer ring buffer with preallocated
+ *          slots.
+ *
+ * Based on Dmitry Vyukov's bounded queue: each slot carries a sequence
+ * number telling producers and consumers whether it is free or filled, so
+ * neither side ever takes a lock. Producers only contend on a single
+ * @code compare_exchange@endcode on the enqueue position, which keeps the
+ * cost of a push flat as the number of producer threads grows.
+ *
+ * Pops also go through a compare-exchange, so it is safe (although not the
+ * intended use) for a producer to pop an element as well.
+ *
+ * The capacity is rounded up to the next power of two.
+ */
+template<typename T>
+class MpscRingBuffer final
+{
+public:
+    /**
+     * @param   capacity    Maximum number of elements the buffer can hold
+     *                      (rounded up to the next power of two)
+     */
+    explicit MpscRingBuffer(std::size_t capacity)
+        : _capacity(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity))
+        , _mask(_capacity - 1)
+        , _slots(std::make_unique<Slot[]>(_capacity))
+    {
+        for (std::size_t k = 0; k < _capacity; ++k) {
+            _slots[k].sequence.store(k, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    ~MpscRingBuffer()
+    {
+        while (pop()) {}
+    }
+
+    /**
+     * @brief   Tries to add an element to the back of the buffer.
+     *
+     * @param   value   The value to push to the buffer
+     * @return  @code false@endcode if the buffer is full. In that case,
+     *          @code value@endcode is left untouched.
+     */
+    bool tryPush(T&& value)
+    {
+        std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;) {
+            slot = &_slots[pos & _mask];
+
+            const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (slot->storage) T(std::move(value));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   Removes the first element of the buffer.
+     *
+     * @return  An @code std::optional<T>@endcode containing
+     *          the popped value, or @code std::nullopt@endcode
+     *          if the buffer is empty.
+     */
+    std::optional<T> pop()
+    {
+        std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;) {
+            slot = &_slots[pos & _mask];
+
+            const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* element = std::launder(reinterpret_cast<T*>(slot->storage));
+        std::optional<T> value(std::move(*element));
+
+        element->~T();
+        slot->sequence.store(pos + _capacity, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @return  An approximation of the number of elements in the buffer.
+     *          Exact when no producer/consumer is running concurrently.
+     */
+    std::size_t size() const
+    {
+        const std::size_t enqueued = _enqueuePos.load(std::memory_order_acquire);
+        const std::size_t dequeued = _dequeuePos.load(std::memory_order_acquire);
+
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    /**
+     * @return  @code true@endcode if no items are stored in the buffer.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @return  The maximum number of elements the buffer can hold.
+     */
+    std::size_t capacity() const { return _capacity; }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    const std::size_t _capacity;
+    const std::size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+
+    // positions live on their own cache lines so that producers and the
+    // consumer don't invalidate each other's lines on every operation.
+    alignas(64) std::atomic<std::size_t> _enqueuePos{0};
+    alignas(64) std::atomic<std::size_t> _dequeuePos{0};
+};
+
+#endif //SHUVLOG_MPSCRINGBUFFER_H
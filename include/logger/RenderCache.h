@@ -0,0 +1,117 @@
+#ifndef SHUVLOG_RENDERCACHE_H
+#define SHUVLOG_RENDERCACHE_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Callsite.h"
+#include "Log.h"
+#include "Sink.h"
+#include "Timestamp.h"
+
+namespace logger
+{
+
+/**
+ * @brief   Formats that can be rendered once per batch, and shared by every
+ *          sink that uses them.
+ */
+enum class RenderFormat : uint8_t
+{
+    kText,  ///< Lines of @code logger::text::appendLog()@endcode
+    kJson,  ///< Lines of @code logger::json::appendLog()@endcode
+};
+
+/**
+ * @class   RenderedBatch
+ * @brief   The logs of a batch rendered in a given format, one line each
+ *          (newline included).
+ *
+ * Only logs of the levels requested so far are rendered, others are empty.
+ */
+class RenderedBatch final
+{
+public:
+    /// @return The rendered line of the log at the given index of the batch
+    [[nodiscard]] std::string_view get(std::size_t index) const
+    {
+        const uint32_t begin = index == 0 ? 0 : _ends[index - 1];
+
+        return std::string_view(_text).substr(begin, _ends[index] - begin);
+    }
+
+    /**
+     * @brief   Lines of the logs of the given levels, in order.
+     *
+     * @param   levels  Levels to keep
+     * @param   scratch Buffer to gather the lines in, if needed
+     * @return  A view on the rendered text when every log is kept, on
+     *          @code scratch@endcode otherwise.
+     */
+    [[nodiscard]] std::string_view select(uint16_t levels, std::string& scratch) const;
+
+private:
+    friend class RenderCache;
+
+    RenderFormat _format = RenderFormat::kText;
+    sink::Settings _settings;
+    uint16_t _renderedLevels = 0;
+    uint16_t _batchLevels = 0;
+    std::span<const Log> _logs;
+    std::string _text;
+    std::vector<uint32_t> _ends;
+    TimestampRenderer _timestampRenderer;
+    CallsiteCache _sources; // for _format and _settings
+};
+
+/**
+ * @class   RenderCache
+ * @brief   Renders each format of a batch only once, whatever the number of
+ *          sinks that write it.
+ *
+ * Sinks with the same format and settings (e.g. a console and a log file,
+ * or a JSON and an NDJSON file) then share the same rendered lines, and only
+ * differ in how they frame them.
+ *
+ * @warning Not thread-safe: each thread writing batches uses its own cache.
+ */
+class RenderCache final
+{
+public:
+    /**
+     * @brief   Starts a new batch, forgetting everything rendered so far (but
+     *          keeping the memory).
+     *
+     * @param   logs    The batch, that must outlive its use by the cache
+     */
+    void reset(std::span<const Log> logs);
+
+    /**
+     * @brief   Renders the batch in a format, if it hasn't been already.
+     *
+     * @param   format          Format to render
+     * @param   settings        Settings of the format (ignored by JSON)
+     * @param   acceptedLevels  Levels of the logs that must be rendered
+     * @return  The rendered batch, valid until the next call to
+     *          @code reset()@endcode.
+     */
+    const RenderedBatch& get(RenderFormat format, const sink::Settings& settings, uint16_t acceptedLevels);
+
+private:
+    /**
+     * @brief   (Re-)renders the logs of the given levels.
+     */
+    static void render(RenderedBatch& rendered, uint16_t levels);
+
+    std::span<const Log> _logs;
+    uint16_t _batchLevels = 0;
+    std::vector<RenderedBatch> _rendered;
+    std::size_t _used = 0;
+};
+
+}
+
+#endif //SHUVLOG_RENDERCACHE_H
@@ -0,0 +1,92 @@
+#ifndef SHUVLOG_SAMPLING_H
+#define SHUVLOG_SAMPLING_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace logger
+{
+
+/**
+ * @struct  Probability
+ * @brief   Sampling rate of the @code LOG_*_SAMPLED@endcode macros that keeps
+ *          each log with a given probability, rather than exactly 1 in N.
+ *
+ * @code
+ * LOG_INFO_SAMPLED(logger::Probability{ 0.001 }, "request {} served", id);
+ * @endcode
+ */
+struct Probability
+{
+    double value;
+};
+
+}
+
+namespace logger::detail
+{
+
+    /**
+     * @brief   Number of calls of a sampled call site so far, one counter per
+     *          call site (@code Site@endcode being a type unique to it).
+     */
+    template<typename Site>
+    inline std::atomic<uint64_t> sampleCounter{0};
+
+    /**
+     * @return  A uniform number in [0, 1), from a per-thread xorshift64*
+     *          generator.
+     */
+    inline double nextUniform()
+    {
+        thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<double>((state * 0x2545F4914F6CDD1D) >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * @return  Whether the call of a call site sampled 1 in @code rate@endcode
+     *          is kept: the first one, then every @code rate@endcode-th.
+     */
+    template<typename Site>
+    bool isSampled(const uint32_t rate)
+    {
+        return rate <= 1 || sampleCounter<Site>.fetch_add(1, std::memory_order_relaxed) % rate == 0;
+    }
+
+    /**
+     * @return  Whether the call of a call site sampled with a probability is
+     *          kept.
+     */
+    template<typename Site>
+    bool isSampled(const Probability probability)
+    {
+        return nextUniform() < probability.value;
+    }
+
+    /// @return The number of logs a kept log stands for.
+    inline uint32_t toSampleRate(const uint32_t rate)
+    {
+        return rate < 1 ? 1 : rate;
+    }
+
+    /// @return The number of logs a kept log stands for, on average.
+    inline uint32_t toSampleRate(const Probability probability)
+    {
+        if (probability.value >= 1) {
+            return 1;
+        }
+        if (probability.value <= 1.0 / std::numeric_limits<uint32_t>::max()) {
+            return std::numeric_limits<uint32_t>::max();
+        }
+        return static_cast<uint32_t>(std::lround(1 / probability.value));
+    }
+
+}
+
+#endif //SHUVLOG_SAMPLING_H
@@ -1,11 +1,71 @@
 #ifndef SHUVLOG_SETTINGS_H
 #define SHUVLOG_SETTINGS_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
+#include "Level.h"
+#include "Exceptions/InvalidLevel.h"
+
 namespace logger
 {
 
+/**
+ * @enum    QueueBackend
+ * @brief   Determines which container carries logs from producers to the
+ *          worker thread.
+ */
+enum class QueueBackend
+{
+    kMutex,     ///< Unbounded queue guarded by a mutex (default)
+    kLockFree,  ///< Bounded lock-free ring buffer, producers never take a lock
+    kPerThread, ///< One bounded lock-free buffer per producer thread
+};
+
+/**
+ * @enum    OverflowPolicy
+ * @brief   Determines what happens to a log pushed while the queue is full.
+ */
+enum class OverflowPolicy
+{
+    kBlock,         ///< The producer waits until the worker frees some room (default)
+    kDropNewest,    ///< The pushed log is dropped
+    kDropOldest,    ///< The oldest queued log is dropped to make room
+    kDropByLevel,   ///< Logs below WARNING are dropped, the others wait for room
+};
+
+/**
+ * @enum    ClockSource
+ * @brief   Determines how producers timestamp their logs.
+ *
+ * Producers only read raw ticks. The worker converts them to wall-clock time
+ * with a periodically recalibrated offset (and frequency, for the TSC), so
+ * @code Log::getTimestamp()@endcode still returns a
+ * @code std::chrono::system_clock@endcode time point.
+ */
+enum class ClockSource
+{
+    kSystem,    ///< @code std::chrono::system_clock@endcode, no conversion (default)
+    kSteady,    ///< @code std::chrono::steady_clock@endcode
+    kTsc,       ///< CPU timestamp counter (x86 only, @code kSteady@endcode elsewhere)
+};
+
+/**
+ * @struct  RateLimit
+ * @brief   How many logs a single call site may emit (see
+ *          @code Settings::setRateLimit()@endcode).
+ */
+struct RateLimit
+{
+    /// Logs per second a call site may emit in the long run (0: unlimited).
+    uint32_t logsPerSecond = 0;
+    /// Logs a call site may emit at once, after having been quiet for a while.
+    uint32_t burst = 1;
+
+    [[nodiscard]] bool isEnabled() const { return logsPerSecond != 0; }
+};
+
 /**
  * @class   Settings
  * @brief   Configuration options to customize logging behavior.
@@ -37,12 +97,236 @@ public:
     /// @return The flush interval in milliseconds.
     [[nodiscard]] int getFlushIntervalMs() const { return _flushIntervalMs; }
 
+    /// @return The container used to carry logs to the worker thread.
+    [[nodiscard]] QueueBackend getQueueBackend() const { return _queueBackend; }
+
+    /// @return The number of slots preallocated by bounded queue backends.
+    [[nodiscard]] size_t getQueueCapacity() const { return _queueCapacity; }
+
+    /// @return Whether formatting is moved from producers to the worker thread.
+    [[nodiscard]] bool isFormattingDeferred() const { return _deferFormatting; }
+
+    /// @return The number of slots preallocated for each producer thread.
+    [[nodiscard]] size_t getThreadBufferCapacity() const { return _threadBufferCapacity; }
+
+    /// @return The maximum number of queued logs, @code 0@endcode if unlimited.
+    [[nodiscard]] size_t getMaxQueuedLogs() const { return _maxQueuedLogs; }
+
+    /// @return The maximum memory used by queued logs, @code 0@endcode if unlimited.
+    [[nodiscard]] size_t getMaxQueuedBytes() const { return _maxQueuedBytes; }
+
+    /// @return What happens to a log pushed while the queue is full.
+    [[nodiscard]] OverflowPolicy getOverflowPolicy() const { return _overflowPolicy; }
+
+    /// @return Whether each sink is written by its own thread.
+    [[nodiscard]] bool isThreadPerSink() const { return _threadPerSink; }
+
+    /// @return How producers timestamp their logs.
+    [[nodiscard]] ClockSource getClockSource() const { return _clockSource; }
+
+    /// @return The number of low-level logs each thread holds back, @code 0@endcode if disabled.
+    [[nodiscard]] size_t getBacktraceDepth() const { return _backtraceDepth; }
+
+    /// @return The highest level held back by backtraces.
+    [[nodiscard]] Level getBacktraceLevel() const { return _backtraceLevel; }
+
+    /// @return The lowest level that releases a thread's backtrace.
+    [[nodiscard]] Level getBacktraceTrigger() const { return _backtraceTrigger; }
+
+    /**
+     * @return  The rate limit of a level's call sites: the level's own, or
+     *          the global one if it has none.
+     */
+    [[nodiscard]] RateLimit getRateLimit(Level level) const
+    {
+        const RateLimit& limit = _levelRateLimits[level::toIndex(level)];
+
+        return limit.isEnabled() ? limit : _rateLimit;
+    }
+
+    /// @return Whether consecutive identical messages of a call site are collapsed.
+    [[nodiscard]] bool isCollapsingRepeats() const { return _collapseRepeats; }
+
+    /// @return The minimum interval between two "messages dropped" reports.
+    [[nodiscard]] int getDropReportIntervalMs() const { return _dropReportIntervalMs; }
+
     void setMaxBatchSize(size_t maxBatchSize) { _maxBatchSize = maxBatchSize; }
     void setFlushIntervalMs(int flushIntervalMs) { _flushIntervalMs = flushIntervalMs; }
 
+    /**
+     * @brief   Captures format arguments on the calling thread, and lets the
+     *          worker thread do the actual formatting.
+     *
+     * Only applies to logs whose arguments can all be captured
+     * (see @code logger::DeferredArg@endcode). Other logs are formatted
+     * right away.
+     */
+    void setDeferFormatting(bool deferFormatting) { _deferFormatting = deferFormatting; }
+
+    /**
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setQueueBackend(QueueBackend queueBackend) { _queueBackend = queueBackend; }
+
+    /**
+     * @note    Rounded up to the next power of two. Ignored by unbounded
+     *          backends (@code QueueBackend::kMutex@endcode).
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setQueueCapacity(size_t queueCapacity) { _queueCapacity = queueCapacity; }
+
+    /**
+     * @note    Rounded up to the next power of two. Only used by
+     *          @code QueueBackend::kPerThread@endcode.
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setThreadBufferCapacity(size_t threadBufferCapacity) { _threadBufferCapacity = threadBufferCapacity; }
+
+    /**
+     * @brief   Bounds the number of logs waiting for the worker.
+     *
+     * @note    @code 0@endcode (default) means unlimited. Bounded backends
+     *          are limited by their capacity anyway.
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setMaxQueuedLogs(size_t maxQueuedLogs) { _maxQueuedLogs = maxQueuedLogs; }
+
+    /**
+     * @brief   Bounds the memory used by logs waiting for the worker
+     *          (records and out-of-line messages).
+     *
+     * @note    @code 0@endcode (default) means unlimited.
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setMaxQueuedBytes(size_t maxQueuedBytes) { _maxQueuedBytes = maxQueuedBytes; }
+
+    /**
+     * @note    @code QueueBackend::kPerThread@endcode can't drop another
+     *          thread's logs: @code OverflowPolicy::kDropOldest@endcode
+     *          behaves like @code OverflowPolicy::kDropNewest@endcode there.
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setOverflowPolicy(OverflowPolicy overflowPolicy) { _overflowPolicy = overflowPolicy; }
+
+    void setDropReportIntervalMs(int dropReportIntervalMs) { _dropReportIntervalMs = dropReportIntervalMs; }
+
+    /**
+     * @note    @code ClockSource::kTsc@endcode assumes an invariant TSC,
+     *          synchronized across cores, which is the case on any recent
+     *          x86 CPU.
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setClockSource(ClockSource clockSource) { _clockSource = clockSource; }
+
+    /**
+     * @brief   Gives each sink its own thread and queue, fed by the Logger's
+     *          worker, so that a slow sink can't delay the others.
+     *
+     * Each sink's thread is configured through
+     * @code logger::Sink::setThreadSettings()@endcode.
+     *
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setThreadPerSink(bool threadPerSink) { _threadPerSink = threadPerSink; }
+
+    /**
+     * @brief   Holds back each thread's last low-level logs, and only queues
+     *          them when that thread logs an error.
+     *
+     * Logs up to @code level@endcode are kept in a buffer of the thread that
+     * logs them (the oldest ones being discarded), instead of being queued.
+     * When the thread logs at @code trigger@endcode or above, the buffered
+     * logs are queued first, in order: sinks get the context that led to the
+     * error, while the queue only carries higher levels the rest of the time.
+     *
+     * @param   depth   Number of logs held back per thread (@code 0@endcode
+     *                  disables backtraces, default)
+     * @param   level   Highest level held back
+     * @param   trigger Lowest level that releases the backtrace, above
+     *                  @code level@endcode
+     *
+     * @throws  exception::InvalidLevel if @code trigger@endcode isn't above
+     *          @code level@endcode: a log can't be both held back and
+     *          released by itself.
+     *
+     * @note    Held back logs that no error follows are never written, and
+     *          are lost when their thread exits. Those that are written come
+     *          after the higher levels logged in the meantime.
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setBacktrace(size_t depth, Level level = Level::kTraceR1, Level trigger = Level::kError)
+    {
+        if (static_cast<uint16_t>(level) >= static_cast<uint16_t>(trigger)) {
+            throw exception::InvalidLevel("Backtraces require a trigger level above the levels they hold back.");
+        }
+        _backtraceDepth = depth;
+        _backtraceLevel = level;
+        _backtraceTrigger = trigger;
+    }
+
+    /**
+     * @brief   Limits how many logs each call site may emit, whatever its
+     *          level (unless the level has its own limit).
+     *
+     * Checked on the calling thread before anything is formatted: logs over
+     * the limit cost almost nothing, and never reach the queue. How many
+     * have been dropped is told by the next log of the call site that gets
+     * through.
+     *
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setRateLimit(const RateLimit& rateLimit) { _rateLimit = rateLimit; }
+
+    /**
+     * @brief   Limits how many logs of a level each call site may emit,
+     *          instead of the global limit.
+     *
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setRateLimit(Level level, const RateLimit& rateLimit) { _levelRateLimits[level::toIndex(level)] = rateLimit; }
+
+    /**
+     * @brief   Collapses consecutive identical messages of a call site into a
+     *          single "Last message repeated N times" log.
+     *
+     * Messages are compared through their arguments, so that repeats are
+     * dropped before being formatted (see @code logger::RepeatKey@endcode).
+     *
+     * @warning Only taken into account when passed to
+     *          @code Logger::initialize()@endcode.
+     */
+    void setCollapseRepeats(bool collapseRepeats) { _collapseRepeats = collapseRepeats; }
+
 private:
     size_t _maxBatchSize;
     int _flushIntervalMs;
+    QueueBackend _queueBackend = QueueBackend::kMutex;
+    size_t _queueCapacity = 8192;
+    size_t _threadBufferCapacity = 1024;
+    bool _deferFormatting = false;
+    size_t _maxQueuedLogs = 0;
+    size_t _maxQueuedBytes = 0;
+    OverflowPolicy _overflowPolicy = OverflowPolicy::kBlock;
+    int _dropReportIntervalMs = 1000;
+    ClockSource _clockSource = ClockSource::kSystem;
+    bool _threadPerSink = false;
+    size_t _backtraceDepth = 0;
+    Level _backtraceLevel = Level::kTraceR1;
+    Level _backtraceTrigger = Level::kError;
+    RateLimit _rateLimit;
+    std::array<RateLimit, level::kCount> _levelRateLimits{};
+    bool _collapseRepeats = false;
 };
 
 }
@@ -1,7 +1,12 @@
 #ifndef SHUVLOG_SINK_H
 #define SHUVLOG_SINK_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "BuildInfo.h"
 #include "Log.h"
@@ -34,6 +39,35 @@ namespace sink
         bool showSource = true;
         bool showLineNumber = true;
         bool showColumnNumber = true;
+
+        bool operator==(const Settings&) const = default;
+    };
+
+    /**
+     * @struct  ThreadSettings
+     * @brief   Configures the dedicated thread of a sink, when the Logger
+     *          runs one thread per sink
+     *          (see @code logger::Settings::setThreadPerSink()@endcode).
+     */
+    struct ThreadSettings
+    {
+        /// Number of written logs after which the sink is flushed.
+        std::size_t maxBatchSize = 256;
+        /// Maximum time between two flushes, in milliseconds.
+        int flushIntervalMs = 250;
+        /// Number of batches the sink can lag behind before batches are dropped.
+        std::size_t queueCapacity = 1024;
+    };
+
+    /**
+     * @struct  Lag
+     * @brief   How far behind the Logger a sink running on its own thread is.
+     */
+    struct Lag
+    {
+        std::size_t pendingLogs = 0;    ///< Logs handed to the sink, not written yet
+        std::size_t pendingBatches = 0; ///< Batches handed to the sink, not written yet
+        uint64_t droppedLogs = 0;       ///< Logs dropped because the sink's queue was full
     };
 
     /**
@@ -69,8 +103,20 @@ namespace sink
 
     }
 
+    /**
+     * @brief   Joins command-line arguments with spaces, as displayed in
+     *          headers.
+     *
+     * @param   argc    Number of command-line arguments (given in main)
+     * @param   argv    Array of command-line arguments (given in main)
+     * @return  The command (e.g., "./app --verbose config.toml")
+     */
+    std::string toCommand(int argc, const char* argv[]);
+
 }
 
+class RenderCache;
+
 /**
  * @class   Sink
  * @brief   Abstract base class for all log sinks.
@@ -115,6 +161,35 @@ public:
      */
     virtual void write(const Log& log) = 0;
 
+    /**
+     * @brief   Writes a batch of log entries to the sink.
+     *
+     * Logs whose level doesn't pass the sink's filter are skipped.
+     *
+     * The default implementation calls @code write()@endcode for each
+     * accepted log. Sinks should override it to format the whole batch at
+     * once, and hand it to their output in a single write.
+     *
+     * @param   logs    The log entries to be written, in order
+     */
+    virtual void writeBatch(std::span<const Log> logs);
+
+    /**
+     * @brief   Writes a batch of log entries, that other sinks may already
+     *          have rendered.
+     *
+     * This is what the Logger calls. Sinks that use a shared format get its
+     * lines from the cache instead of formatting the logs themselves, so that
+     * each format is rendered once per batch whatever the number of sinks.
+     *
+     * The default implementation ignores the cache and calls
+     * @code writeBatch()@endcode.
+     *
+     * @param   logs    The log entries to be written, in order
+     * @param   cache   Formats already rendered for this batch
+     */
+    virtual void writeRendered(std::span<const Log> logs, RenderCache& cache);
+
     /**
      * @brief   Writes an initialization header to the sink.
      *
@@ -153,9 +228,52 @@ public:
      * @param   level The level to check
      * @return  true if the level passes the current filter
      */
-    [[nodiscard]] bool shouldLog(Level level) const;
+    [[nodiscard]] bool shouldLog(Level level) const
+    {
+        return (_acceptedLevels.load(std::memory_order_relaxed) & static_cast<uint16_t>(level)) != 0;
+    }
+
+    /**
+     * @return  Bitwise OR of every level that passes the current filter.
+     */
+    [[nodiscard]] uint16_t getAcceptedLevels() const
+    {
+        return _acceptedLevels.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief   Changes the level filter of the sink.
+     *
+     * @warning When the sink is attached to the Logger, use
+     *          @code Logger::setSinkFilter()@endcode instead, so that the
+     *          Logger stops discarding levels the sink now accepts.
+     *
+     * @param   filterMode  Filtering mode to use
+     * @param   levelMask   Level specification (see constructor)
+     *
+     * @throws  exception::InvalidLevel if kMinimumLevel mode receives OR'd levels
+     */
+    void setFilter(sink::FilterMode filterMode, uint16_t levelMask);
+
+    /// @return The settings of the sink's dedicated thread.
+    [[nodiscard]] const sink::ThreadSettings& getThreadSettings() const { return _threadSettings; }
+
+    /**
+     * @brief   Configures the sink's dedicated thread.
+     *
+     * @warning Only taken into account when the thread starts, i.e. when the
+     *          Logger is initialized, or when the sink is added to an
+     *          initialized Logger.
+     */
+    void setThreadSettings(const sink::ThreadSettings& threadSettings) { _threadSettings = threadSettings; }
 
 protected:
+    /**
+     * @return  The levels to display in headers: the minimum level, the
+     *          explicitly accepted ones, or none if every level is accepted.
+     */
+    [[nodiscard]] std::vector<Level> getDisplayedLevels() const;
+
     sink::Settings _settings;
     sink::FilterMode _filterMode;
     Level _minimumLevel;
@@ -168,6 +286,11 @@ private:
      * @return  @code true@endcode if exactly one bit is set
      */
     static bool isSingleLevel(uint16_t value);
+
+    sink::ThreadSettings _threadSettings;
+
+    /// Precomputed from the filter, so that @code shouldLog()@endcode is a single AND.
+    std::atomic<uint16_t> _acceptedLevels{0xFFFF};
 };
 
 }
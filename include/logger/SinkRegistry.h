@@ -0,0 +1,111 @@
+#ifndef SHUVLOG_SINKREGISTRY_H
+#define SHUVLOG_SINKREGISTRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Sink.h"
+#include "SinkWorker.h"
+
+namespace logger
+{
+
+/**
+ * @class   SinkRegistry
+ * @brief   Set of the Sinks attached to the Logger, published as immutable
+ *          snapshots.
+ *
+ * Every change (adding or removing a Sink, starting their threads...) builds
+ * a new snapshot, and publishes it with a single atomic store. The Logger's
+ * worker reads the current snapshot with one atomic load: it never takes a
+ * lock, never allocates, and never waits for a writer.
+ *
+ * A replaced snapshot is freed once the worker is done with it. The worker
+ * announces the snapshot it is reading through a hazard pointer, that
+ * writers check before freeing anything.
+ *
+ * @warning Writer operations (@code current()@endcode, @code publish()@endcode,
+ *          @code waitForReader()@endcode) must be serialized by the caller.
+ *          Reader operations must only be called by a single thread.
+ */
+class SinkRegistry final
+{
+public:
+    struct Entry
+    {
+        std::shared_ptr<Sink> sink;
+        /// Dedicated thread of the Sink, if any.
+        std::shared_ptr<SinkWorker> worker;
+    };
+
+    struct Snapshot
+    {
+        std::vector<Entry> entries;
+    };
+
+    /**
+     * @brief   Read access to the current snapshot, valid until destroyed.
+     */
+    class Reader final
+    {
+    public:
+        explicit Reader(SinkRegistry& registry);
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        ~Reader();
+
+        const Snapshot& operator*() const { return *_snapshot; }
+        const Snapshot* operator->() const { return _snapshot; }
+
+    private:
+        SinkRegistry& _registry;
+        const Snapshot* _snapshot;
+    };
+
+    SinkRegistry();
+    SinkRegistry(const SinkRegistry&) = delete;
+    SinkRegistry& operator=(const SinkRegistry&) = delete;
+    ~SinkRegistry();
+
+    /**
+     * @return  @code true@endcode if no Sink is attached. Can be called from
+     *          any thread.
+     */
+    [[nodiscard]] bool empty() const { return _size.load(std::memory_order_relaxed) == 0; }
+
+    /**
+     * @return  The current snapshot. Writer side only.
+     */
+    [[nodiscard]] const Snapshot& current() const;
+
+    /**
+     * @brief   Replaces the current snapshot. Writer side only.
+     *
+     * @param   snapshot    The new snapshot
+     */
+    void publish(Snapshot snapshot);
+
+    /**
+     * @brief   Waits until the reader is done with every snapshot but the
+     *          current one, so that Sinks that have been removed are not
+     *          written anymore. Writer side only.
+     */
+    void waitForReader();
+
+private:
+    /**
+     * @brief   Frees the replaced snapshots the reader isn't using.
+     */
+    void reclaim();
+
+    std::atomic<const Snapshot*> _snapshot;
+    std::atomic<const Snapshot*> _hazard{nullptr};
+    std::atomic<std::size_t> _size{0};
+    std::vector<const Snapshot*> _retired;
+};
+
+}
+
+#endif //SHUVLOG_SINKREGISTRY_H
@@ -0,0 +1,111 @@
+#ifndef SHUVLOG_SINKWORKER_H
+#define SHUVLOG_SINKWORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Log.h"
+#include "RenderCache.h"
+#include "Sink.h"
+
+namespace logger
+{
+
+/**
+ * @class   SinkWorker
+ * @brief   Dedicated consumer thread of a single Sink.
+ *
+ * Used when @code logger::Settings::setThreadPerSink()@endcode is enabled:
+ * the Logger's worker resolves each batch once, and hands it to every
+ * SinkWorker, that writes it to its Sink at its own pace. A slow Sink (e.g.
+ * a console behind a slow terminal) then only delays itself.
+ *
+ * Batches are shared between SinkWorkers, and released by the last one to
+ * be done with them.
+ *
+ * Each SinkWorker buffers up to @code sink::ThreadSettings::queueCapacity@endcode
+ * batches. When its queue is full, new batches are dropped for this Sink
+ * only, and counted in its @code sink::Lag@endcode.
+ */
+class SinkWorker final
+{
+public:
+    using Batch = std::shared_ptr<const std::vector<Log>>;
+
+    /**
+     * @brief   Starts the consumer thread.
+     *
+     * @param   sink    Sink to write batches to
+     */
+    explicit SinkWorker(std::shared_ptr<Sink> sink);
+
+    SinkWorker(const SinkWorker&) = delete;
+    SinkWorker& operator=(const SinkWorker&) = delete;
+
+    /**
+     * @brief   Stops the consumer thread, after it has written every queued
+     *          batch.
+     */
+    ~SinkWorker();
+
+    /**
+     * @brief   Queues a batch for the Sink.
+     *
+     * @param   batch   Batch to write, shared with other SinkWorkers
+     * @param   count   Number of logs of the batch the Sink accepts
+     */
+    void push(Batch batch, std::size_t count);
+
+    /**
+     * @brief   Writes every queued batch, flushes the Sink and stops the
+     *          consumer thread. Does nothing if already stopped.
+     */
+    void stop();
+
+    /**
+     * @return  How far behind the Logger the Sink is.
+     */
+    [[nodiscard]] sink::Lag getLag() const;
+
+    [[nodiscard]] const std::shared_ptr<Sink>& getSink() const { return _sink; }
+
+    /// @return Whether the calling thread is the consumer thread.
+    [[nodiscard]] bool isCurrentThread() const { return std::this_thread::get_id() == _thread.get_id(); }
+
+private:
+    struct QueuedBatch
+    {
+        Batch batch;
+        std::size_t count = 0;
+    };
+
+    void run();
+
+    std::shared_ptr<Sink> _sink;
+    const sink::ThreadSettings _settings;
+    // each sink thread renders on its own: caches aren't shared across threads.
+    RenderCache _renderCache;
+
+    // bounded ring of batches, guarded by _mutex
+    mutable std::mutex _mutex;
+    std::condition_variable _cvar;
+    std::vector<QueuedBatch> _queue;
+    std::size_t _head = 0;
+    std::size_t _size = 0;
+    bool _isStopping = false;
+
+    std::atomic<std::size_t> _pendingLogs{0};
+    std::atomic<uint64_t> _droppedLogs{0};
+
+    std::thread _thread;
+};
+
+}
+
+#endif //SHUVLOG_SINKWORKER_H
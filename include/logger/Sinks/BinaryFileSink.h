@@ -0,0 +1,118 @@
+#ifndef SHUVLOG_BINARYFILESINK_H
+#define SHUVLOG_BINARYFILESINK_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../BinaryFormat.h"
+#include "../FileSink.h"
+
+namespace logger
+{
+
+/**
+ * @class   BinaryFileSink
+ *
+ * This sink writes compact binary records to a @code .shlog@endcode file,
+ * without formatting anything: the message is written as is, and the
+ * timestamp, thread and source location are encoded in a few bytes.
+ * Thread identities and source locations are written once, the first time
+ * they are seen.
+ *
+ * Files are turned back into @code .log@endcode or @code .ndjson@endcode text
+ * with the @code shuvlog-decode@endcode tool, which is where formatting is
+ * actually paid for.
+ *
+ * @see @code logger::binary@endcode for the file layout.
+ *
+ * @note    Formatting settings (@code sink::Settings@endcode) are written
+ *          in the file, and applied by the decoder when it renders
+ *          @code .log@endcode text (not by this sink).
+ *
+ * @warning Registering multiple file sinks targeting the same output file
+ *          will throw a @code DuplicateSink@endcode exception.
+ */
+class BinaryFileSink : public FileSink
+{
+public:
+    explicit BinaryFileSink(
+        const std::string& filepath,
+        sink::Settings settings = sink::Settings()
+    );
+
+    explicit BinaryFileSink(
+        const std::string& filepath,
+        sink::FilterMode filterMode,
+        uint16_t levelMask,
+        sink::Settings settings = sink::Settings()
+    );
+
+    void write(const Log& log) override;
+    void writeBatch(std::span<const Log> logs) override;
+    void writeHeader(
+        const std::string& projectName,
+        int argc,
+        const char* argv[],
+        const BuildInfo& buildInfo,
+        const Settings& settings
+    ) override;
+    void flush() override;
+    void close() override;
+
+protected:
+    /**
+     * @brief   Forgets the threads and callsites defined so far, so that each
+     *          file can be decoded on its own.
+     */
+    void onFileRotated() override;
+
+private:
+    struct KnownThread
+    {
+        uint64_t version = 0; // of the snapshot defined
+        uint64_t id = 0;
+    };
+
+    /**
+     * @brief   Appends a sync record, that the next log's timestamp is
+     *          relative to.
+     */
+    void appendSync(int64_t timestamp);
+
+    /**
+     * @brief   Appends a log record, preceded by the definition of its thread
+     *          and callsite if they haven't been written yet.
+     */
+    void appendLog(const Log& log);
+
+    /**
+     * @return  The id of the log's thread, defined in the buffer if needed.
+     */
+    uint64_t getThreadId(const Log& log);
+
+    /**
+     * @return  The id of the log's callsite, defined in the buffer if needed.
+     */
+    uint64_t getCallsiteId(const Log& log);
+
+    /**
+     * @brief   Appends a record whose payload has been built in
+     *          @code _record@endcode.
+     */
+    void appendRecord(binary::Record record);
+
+    std::string _buffer; // reused from one batch to the next
+    std::string _record; // payload of the record being built
+    int64_t _lastTimestamp = 0;
+
+    // indexed by ThreadInfo::index
+    std::vector<KnownThread> _threads;
+    uint64_t _threadCount = 0;
+    std::unordered_map<const Callsite*, uint64_t> _callsites;
+};
+
+}
+
+#endif //SHUVLOG_BINARYFILESINK_H
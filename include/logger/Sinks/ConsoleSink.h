@@ -1,7 +1,10 @@
 #ifndef SHUVLOG_CONSOLESINK_H
 #define SHUVLOG_CONSOLESINK_H
 
+#include <string>
+
 #include "../Sink.h"
+#include "../RenderCache.h"
 
 namespace logger
 {
@@ -31,6 +34,8 @@ public:
     );
 
     void write(const Log& log) override;
+    void writeBatch(std::span<const Log> logs) override;
+    void writeRendered(std::span<const Log> logs, RenderCache& cache) override;
     void writeHeader(
         const std::string& projectName,
         int argc,
@@ -42,7 +47,14 @@ public:
     void close() override;
 
 private:
+    /**
+     * @brief   Appends a rendered log, with its colors, to the buffer.
+     */
+    void appendLog(const Log& log, std::string_view line);
+
     bool _useColors;
+    std::string _buffer; // reused from one batch to the next
+    RenderCache _renderCache; // for batches written outside of the Logger
 };
 
 }
@@ -1,7 +1,10 @@
 #ifndef SHUVLOG_JSONFILESINK_H
 #define SHUVLOG_JSONFILESINK_H
 
+#include <string>
+
 #include "../FileSink.h"
+#include "../RenderCache.h"
 
 namespace logger
 {
@@ -15,6 +18,10 @@ namespace logger
  * Each log entry is written as a JSON object, allowing automated processing,
  * or integration with log analysis tools.
  *
+ * Entries are appended as they come, and the document is closed
+ * (@code ]}@endcode) on each flush: the file is valid JSON after every flush,
+ * and once the sink is closed.
+ *
  * @warning Registering multiple file sinks targeting the same output file
  *          will throw a @code DuplicateSink@endcode exception.
  */
@@ -34,6 +41,8 @@ public:
     );
 
     void write(const Log& log) override;
+    void writeBatch(std::span<const Log> logs) override;
+    void writeRendered(std::span<const Log> logs, RenderCache& cache) override;
     void writeHeader(
         const std::string& projectName,
         int argc,
@@ -43,6 +52,18 @@ public:
     ) override;
     void flush() override;
     void close() override;
+
+protected:
+    void onFileClosing() override;
+    void onFileRotated() override;
+
+private:
+    std::string _buffer; // reused from one batch to the next
+    RenderCache _renderCache; // for batches written outside of the Logger
+    // whether the "logs" array has an entry, and whether the closing "]}" is
+    // currently at the end of the file.
+    bool _hasEntries = false;
+    bool _hasFooter = false;
 };
 
 }
@@ -1,7 +1,10 @@
 #ifndef SHUVLOG_LOGFILESINK_H
 #define SHUVLOG_LOGFILESINK_H
 
+#include <string>
+
 #include "../FileSink.h"
+#include "../RenderCache.h"
 
 namespace logger
 {
@@ -35,6 +38,8 @@ public:
     );
 
     void write(const Log& log) override;
+    void writeBatch(std::span<const Log> logs) override;
+    void writeRendered(std::span<const Log> logs, RenderCache& cache) override;
     void writeHeader(
         const std::string& projectName,
         int argc,
@@ -44,6 +49,10 @@ public:
     ) override;
     void flush() override;
     void close() override;
+
+private:
+    std::string _buffer; // reused from one batch to the next
+    RenderCache _renderCache; // for batches written outside of the Logger
 };
 
 }
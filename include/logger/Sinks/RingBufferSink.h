@@ -0,0 +1,145 @@
+#ifndef SHUVLOG_RINGBUFFERSINK_H
+#define SHUVLOG_RINGBUFFERSINK_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../Log.h"
+#include "../Sink.h"
+
+namespace logger
+{
+
+/**
+ * @class   RingBufferSink
+ *
+ * This sink is a flight recorder: it keeps the last logs it receives in
+ * memory, without formatting nor writing anything, and only hands them to a
+ * target sink when something goes wrong.
+ *
+ * A dump is triggered by a log of the trigger level (or above) going through
+ * the sink, or explicitly with @code dump()@endcode. It writes every retained
+ * log, the trigger included, then starts over with an empty buffer.
+ *
+ * This lets verbose levels be recorded all the time, and only paid for (in
+ * formatting and I/O) when they are needed, around failures.
+ *
+ * @code
+ * Logger::getInstance().addSink<logger::RingBufferSink>(
+ *     std::make_shared<logger::LogFileSink>("crash.log"),
+ *     4096,
+ *     logger::Level::kError
+ * );
+ * @endcode
+ *
+ * Records are kept in preallocated slots: a message that fits inline in a
+ * @code Log@endcode is never allocated, and slots keep the memory of longer
+ * ones from a lap to the next.
+ *
+ * @note    Formatting settings are the target's: this sink formats nothing.
+ *
+ * @warning The target must not be attached to the Logger itself: it is only
+ *          written by this sink, which owns it.
+ */
+class RingBufferSink : public Sink
+{
+public:
+    /**
+     * @param   target          Sink the retained logs are dumped to
+     * @param   capacity        Number of logs retained (the oldest ones are
+     *                          overwritten)
+     * @param   triggerLevel    Lowest level that triggers a dump
+     */
+    explicit RingBufferSink(
+        std::shared_ptr<Sink> target,
+        std::size_t capacity,
+        Level triggerLevel = Level::kError
+    );
+
+    /**
+     * @brief   Same as first RingBufferSink constructor, but only retaining
+     *          the logs that pass the given filter.
+     */
+    explicit RingBufferSink(
+        std::shared_ptr<Sink> target,
+        std::size_t capacity,
+        Level triggerLevel,
+        sink::FilterMode filterMode,
+        uint16_t levelMask
+    );
+
+    ~RingBufferSink() override;
+
+    void write(const Log& log) override;
+    void writeBatch(std::span<const Log> logs) override;
+    void writeHeader(
+        const std::string& projectName,
+        int argc,
+        const char* argv[],
+        const BuildInfo& buildInfo,
+        const Settings& settings
+    ) override;
+    void flush() override;
+    void close() override;
+
+    /**
+     * @brief   Writes the retained logs to the target, and empties the
+     *          buffer.
+     *
+     * Can be called from any thread, e.g. when an operation fails without
+     * logging an error.
+     */
+    void dump();
+
+    /// @return The number of logs currently retained.
+    [[nodiscard]] std::size_t getSize() const;
+
+    /// @return The sink the retained logs are dumped to.
+    [[nodiscard]] const std::shared_ptr<Sink>& getTarget() const { return _target; }
+
+private:
+    /**
+     * @brief   Copy of a log, in a slot of the buffer.
+     */
+    struct Record
+    {
+        uint64_t timestamp = 0;
+        const Callsite* site = nullptr;
+        uint32_t threadIndex = 0;
+        uint32_t sampleRate = 1;
+        std::string message; // keeps its capacity from a lap to the next
+    };
+
+    /**
+     * @brief   Overwrites the oldest slot (if full) with a log.
+     */
+    void record(const Log& log);
+
+    /**
+     * @brief   Writes the retained logs to the target, and empties the
+     *          buffer. The mutex must be held.
+     */
+    void dumpLocked();
+
+    /**
+     * @brief   Empties the buffer, releasing the threads of its records
+     *          (see @code logger::ThreadRegistry::pin()@endcode). The mutex
+     *          must be held.
+     */
+    void unpinAll();
+
+    const std::shared_ptr<Sink> _target;
+    const uint16_t _triggerLevel;
+
+    mutable std::mutex _mutex;
+    std::vector<Record> _records;
+    std::size_t _head = 0; // oldest record
+    std::size_t _size = 0;
+    std::vector<Log> _dump; // reused from one dump to the next
+};
+
+}
+
+#endif //SHUVLOG_RINGBUFFERSINK_H
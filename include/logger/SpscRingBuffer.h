@@ -0,0 +1,138 @@
+#ifndef SHUVLOG_SPSCRINGBUFFER_H
+#define SHUVLOG_SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+
+/**
+ * @class   SpscRingBuffer
+ * @brief   Bounded, lock-free single-producer/single-consumer ring buffer
+ *          with preallocated slots.
+ *
+ * The producer only writes the tail index, and the consumer only writes
+ * the head index. Each side keeps a private copy of the other side's index
+ * and only reloads it when the buffer looks full (or empty), so that in
+ * steady state no cache line is shared between the two threads.
+ *
+ * @warning @code tryPush()@endcode must only be called by one thread, and
+ *          @code pop()@endcode by one (other) thread.
+ *
+ * The capacity is rounded up to the next power of two.
+ */
+template<typename T>
+class SpscRingBuffer final
+{
+public:
+    /**
+     * @param   capacity    Maximum number of elements the buffer can hold
+     *                      (rounded up to the next power of two)
+     */
+    explicit SpscRingBuffer(std::size_t capacity)
+        : _capacity(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity))
+        , _mask(_capacity - 1)
+        , _slots(std::make_unique<Slot[]>(_capacity))
+    {}
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    ~SpscRingBuffer()
+    {
+        while (pop()) {}
+    }
+
+    /**
+     * @brief   Tries to add an element to the back of the buffer.
+     *
+     * @param   value   The value to push to the buffer
+     * @return  @code false@endcode if the buffer is full. In that case,
+     *          @code value@endcode is left untouched.
+     */
+    bool tryPush(T&& value)
+    {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+
+        if (tail - _cachedHead == _capacity) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == _capacity) {
+                return false;
+            }
+        }
+
+        new (_slots[tail & _mask].storage) T(std::move(value));
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   Removes the first element of the buffer.
+     *
+     * @return  An @code std::optional<T>@endcode containing
+     *          the popped value, or @code std::nullopt@endcode
+     *          if the buffer is empty.
+     */
+    std::optional<T> pop()
+    {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) {
+                return std::nullopt;
+            }
+        }
+
+        T* element = std::launder(reinterpret_cast<T*>(_slots[head & _mask].storage));
+        std::optional<T> value(std::move(*element));
+
+        element->~T();
+        _head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @return  An approximation of the number of elements in the buffer.
+     *          Can be called from any thread.
+     */
+    std::size_t size() const
+    {
+        const std::size_t head = _head.load(std::memory_order_acquire);
+        const std::size_t tail = _tail.load(std::memory_order_acquire);
+
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @return  @code true@endcode if no items are stored in the buffer.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @return  The maximum number of elements the buffer can hold.
+     */
+    std::size_t capacity() const { return _capacity; }
+
+private:
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    const std::size_t _capacity;
+    const std::size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+
+    // consumer side
+    alignas(64) std::atomic<std::size_t> _head{0};
+    std::size_t _cachedTail = 0;
+
+    // producer side
+    alignas(64) std::atomic<std::size_t> _tail{0};
+    std::size_t _cachedHead = 0;
+};
+
+#endif //SHUVLOG_SPSCRINGBUFFER_H
@@ -0,0 +1,61 @@
+#ifndef SHUVLOG_TEXTENCODER_H
+#define SHUVLOG_TEXTENCODER_H
+
+#include <string>
+
+#include "Callsite.h"
+#include "Log.h"
+#include "LogFields.h"
+#include "Sink.h"
+#include "Timestamp.h"
+
+/**
+ * @brief   Human-readable line format shared by the console and log file
+ *          sinks (and the decoder).
+ */
+namespace logger::text
+{
+
+    /**
+     * @brief   Appends a log entry as a line (newline included), according to
+     *          the given settings.
+     *
+     * @param   out                 Buffer to append to
+     * @param   log                 Fields of the log entry
+     * @param   settings            Which fields to show
+     * @param   timestampRenderer   Renderer of the timestamp, owned by the caller
+     */
+    void appendLog(
+        std::string& out,
+        const LogFields& log,
+        const sink::Settings& settings,
+        TimestampRenderer& timestampRenderer
+    );
+
+    /**
+     * @brief   Same as above, straight from a log entry.
+     */
+    void appendLog(
+        std::string& out,
+        const Log& log,
+        const sink::Settings& settings,
+        TimestampRenderer& timestampRenderer
+    );
+
+    /**
+     * @brief   Same as above, the source being rendered once per call site.
+     *
+     * @param   sources Sources of the call sites rendered so far, with these
+     *                  settings
+     */
+    void appendLog(
+        std::string& out,
+        const Log& log,
+        const sink::Settings& settings,
+        TimestampRenderer& timestampRenderer,
+        CallsiteCache& sources
+    );
+
+}
+
+#endif //SHUVLOG_TEXTENCODER_H
@@ -1,7 +1,11 @@
 #ifndef SHUVLOG_THREAD_H
 #define SHUVLOG_THREAD_H
 
+#include <cstdint>
 #include <format>
+#include <thread>
+
+#include "ThreadRegistry.h"
 
 namespace logger
 {
@@ -15,18 +19,97 @@ namespace logger
      */
     inline thread_local auto threadLabel = "Unknown";
 
+    /**
+     * @brief   Index of the current thread in the @code ThreadRegistry@endcode.
+     *
+     * @code 0@endcode until the thread logs for the first time.
+     * Each thread receives its own independent instance of this variable
+     * (@code thread_local@endcode).
+     */
+    inline thread_local uint32_t threadIndex = 0;
+
+    /**
+     * @brief   Releases the current thread's index when the thread exits, so
+     *          that a later thread can reuse it.
+     *
+     * Only constructed when the thread registers: @code threadIndex@endcode
+     * stays a plain integer on the logging path.
+     */
+    struct ThreadIndexHandle
+    {
+        bool isRegistered = false;
+
+        ~ThreadIndexHandle()
+        {
+            if (isRegistered && threadIndex != 0) {
+                ThreadRegistry::getInstance().release(threadIndex);
+                threadIndex = 0;
+            }
+        }
+    };
+
+    inline thread_local ThreadIndexHandle threadIndexHandle;
+
     /**
      * @brief   Sets the label for the current thread.
      *
+     * If the thread already logged, the new label is published to the
+     * @code ThreadRegistry@endcode, so that sinks display it.
+     *
      * @param   name    The thread's name
      */
-    inline void setThreadLabel(const char* name) { threadLabel = name; }
+    inline void setThreadLabel(const char* name)
+    {
+        threadLabel = name;
+        if (threadIndex != 0) {
+            ThreadRegistry::getInstance().relabel(threadIndex, name);
+        }
+    }
 
     /**
      * @return  The current thread's label
      */
     inline const char* getThreadLabel() { return threadLabel; }
 
+    /**
+     * @return  The current thread's index in the @code ThreadRegistry@endcode,
+     *          registering the thread if it's the first time it asks.
+     */
+    inline uint32_t getThreadIndex()
+    {
+        if (threadIndex == 0) {
+            threadIndex = ThreadRegistry::getInstance().registerCurrentThread(threadLabel);
+            threadIndexHandle.isRegistered = true;
+        }
+        return threadIndex;
+    }
+
+    class ThreadLogBuffer;
+
+    /**
+     * @brief   Owns the link between a thread and its log buffer.
+     *
+     * Only used with @code QueueBackend::kPerThread@endcode. The buffer is
+     * registered by the Logger the first time the thread logs, and is
+     * marked as closed when the thread exits, so that the worker can release
+     * it once it has been drained.
+     */
+    struct ThreadLogBufferHandle
+    {
+        ThreadLogBuffer* buffer = nullptr;
+
+        ~ThreadLogBufferHandle();
+    };
+
+    /**
+     * @brief   Thread-local log buffer of the current thread.
+     *
+     * Lazily registered the first time the thread logs.
+     * Each thread receives its own independent instance of this variable
+     * (@code thread_local@endcode).
+     */
+    inline thread_local ThreadLogBufferHandle threadLogBuffer;
+
     /**
      * @brief   Formats a thread ID
      *
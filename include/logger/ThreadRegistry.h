@@ -0,0 +1,175 @@
+#ifndef SHUVLOG_THREADREGISTRY_H
+#define SHUVLOG_THREADREGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace logger
+{
+
+/**
+ * @struct  ThreadInfo
+ * @brief   Identity of a thread that logged, rendered once for all.
+ *
+ * Immutable: relabeling a thread publishes a new snapshot.
+ */
+struct ThreadInfo
+{
+    uint32_t index;         ///< Compact id given by the registry (0: unknown thread)
+    std::thread::id id;     ///< Standard thread id
+    uint64_t osId;          ///< Id given by the OS (e.g. Linux tid)
+    std::string label;      ///< Label given to @code setThreadLabel()@endcode
+    std::string prettyId;   ///< Id as displayed by sinks (e.g. "0x7f3a...")
+    uint64_t version = 0;   ///< Unique to the snapshot (unlike its address, never reused)
+};
+
+/**
+ * @class   ThreadRegistry
+ * @brief   Process-wide registry of the threads that logged.
+ *
+ * A thread is registered the first time it logs, and receives a compact
+ * index: that index is all a @code Log@endcode carries, sinks look the
+ * thread's label and pre-rendered id up here.
+ *
+ * Lookups are a couple of atomic loads, and never take a lock. Registering
+ * and relabeling a thread take a lock, but only happen once per thread (and
+ * per @code setThreadLabel()@endcode call).
+ *
+ * Labels are looked up when logs are written, not when they're created:
+ * logs still queued when their thread is relabeled show the new label.
+ *
+ * Snapshots replaced by a relabeling, and the index of a thread that exited,
+ * are retired rather than freed: logs still in flight may point to them.
+ * The Logger's worker reclaims them once every log queued before their
+ * retirement has been written (see @code advanceEpoch()@endcode), and
+ * indices are then reused by the threads that register next. Sinks keeping
+ * logs beyond a batch @code pin()@endcode their threads meanwhile.
+ */
+class ThreadRegistry final
+{
+public:
+    static ThreadRegistry& getInstance();
+
+    ThreadRegistry(const ThreadRegistry&) = delete;
+    ThreadRegistry& operator=(const ThreadRegistry&) = delete;
+
+    /**
+     * @brief   Registers the calling thread.
+     *
+     * @param   label   Current label of the thread
+     * @return  The thread's index, or @code 0@endcode if the registry is full.
+     */
+    uint32_t registerCurrentThread(const char* label);
+
+    /**
+     * @brief   Publishes a new label for a registered thread.
+     *
+     * @param   index   Index returned by @code registerCurrentThread()@endcode
+     * @param   label   New label
+     */
+    void relabel(uint32_t index, const char* label);
+
+    /**
+     * @brief   Retires the index of a thread that exited, along with its
+     *          snapshot.
+     *
+     * @param   index   Index returned by @code registerCurrentThread()@endcode
+     */
+    void release(uint32_t index);
+
+    /**
+     * @brief   Keeps a thread's index and snapshots from being reclaimed,
+     *          until as many @code unpin()@endcode calls.
+     *
+     * For sinks keeping logs beyond the batch they were written with.
+     */
+    void pin(uint32_t index);
+    void unpin(uint32_t index);
+
+    /**
+     * @brief   Starts a new epoch: what is retired from now on won't be
+     *          reclaimed with what was retired before.
+     *
+     * @return  The new epoch, to be given to @code reclaim()@endcode.
+     */
+    uint64_t advanceEpoch();
+
+    /**
+     * @brief   Frees the snapshots retired before an epoch, and makes the
+     *          indices retired before it available again (unless pinned).
+     *
+     * @param   epoch   As returned by @code advanceEpoch()@endcode
+     *
+     * @warning Every log queued before @code advanceEpoch()@endcode returned
+     *          @code epoch@endcode must have been written.
+     */
+    void reclaim(uint64_t epoch);
+
+    /**
+     * @param   index   Index of a thread
+     * @return  The latest snapshot of the thread's identity, or a generic
+     *          "Unknown" one if the index isn't registered.
+     */
+    const ThreadInfo& get(uint32_t index) const;
+
+private:
+    static constexpr std::size_t kChunkSize = 4096;
+    static constexpr std::size_t kMaxChunks = 4096;
+
+    struct Slot
+    {
+        std::atomic<const ThreadInfo*> info{nullptr};
+        std::atomic<uint32_t> pins{0};
+        std::unique_ptr<const ThreadInfo> owned; // guarded by _mutex
+    };
+
+    /**
+     * @brief   Snapshot waiting for the logs that may point to it to be
+     *          written.
+     */
+    struct Retired
+    {
+        std::unique_ptr<const ThreadInfo> info;
+        uint64_t epoch = 0;
+        bool isReleased = false; // the thread exited: its index goes with it
+    };
+
+    using Chunk = std::array<Slot, kChunkSize>;
+
+    ThreadRegistry();
+
+    /**
+     * @return  The slot of an index, or @code nullptr@endcode if its chunk
+     *          hasn't been allocated.
+     */
+    Slot* findSlot(uint32_t index);
+
+    /**
+     * @brief   Stores a snapshot and publishes it in its slot, retiring the
+     *          previous one.
+     *
+     * @warning @code _mutex@endcode must be held.
+     */
+    void publish(std::unique_ptr<ThreadInfo> info);
+
+    std::mutex _mutex;
+    uint32_t _nextIndex = 1;
+    uint64_t _nextVersion = 1;
+    uint64_t _epoch = 0;
+    std::vector<uint32_t> _freeIndices;
+    std::vector<Retired> _retired;
+    std::array<std::atomic<Chunk*>, kMaxChunks> _chunks{};
+    std::vector<std::unique_ptr<Chunk>> _ownedChunks;
+    ThreadInfo _unknown;
+};
+
+}
+
+#endif //SHUVLOG_THREADREGISTRY_H
@@ -1,9 +1,13 @@
 #ifndef SHUVLOG_THREADSAFEQUEUE_H
 #define SHUVLOG_THREADSAFEQUEUE_H
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <vector>
 #include <condition_variable>
 
 template<typename T>
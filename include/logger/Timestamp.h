@@ -2,6 +2,8 @@
 #define SHUVLOG_TIMESTAMP_H
 
 #include <chrono>
+#include <cstddef>
+#include <string>
 
 using namespace std::chrono;
 
@@ -42,4 +44,46 @@ std::string formatTimestamp(
     bool forFilename = false
 );
 
+/**
+ * @class   TimestampRenderer
+ * @brief   Renders timestamps into an existing buffer, caching the date and
+ *          time of the current second.
+ *
+ * Logs come in bursts: thousands of them share the same second, which is only
+ * converted (@code localtime_r@endcode + formatting) once. Within that second,
+ * only the milliseconds are rendered.
+ *
+ * Produces the exact same output as @code formatTimestamp()@endcode.
+ *
+ * @warning Not thread-safe: each thread (or sink) should use its own
+ *          instance.
+ */
+class TimestampRenderer final
+{
+public:
+    /**
+     * @brief   Appends a timestamp to @code out@endcode.
+     *
+     * @param   out                 Buffer to append the timestamp to
+     * @param   timestamp           The UTC time point
+     * @param   showOnlyTime        Whether to include only the time component
+     * @param   showMilliseconds    Whether to show milliseconds in the output
+     */
+    void renderTo(
+        std::string& out,
+        time_point<system_clock> timestamp,
+        bool showOnlyTime = false,
+        bool showMilliseconds = true
+    );
+
+private:
+    /// Length of "YYYY-MM-DD HH:MM:SS".
+    static constexpr std::size_t kDateTimeSize = 19;
+    /// Length of "YYYY-MM-DD ", skipped when only the time is shown.
+    static constexpr std::size_t kDateSize = 11;
+
+    time_point<system_clock, seconds> _cachedSecond = time_point<system_clock, seconds>::min();
+    char _dateTime[kDateTimeSize] = {};
+};
+
 #endif //SHUVLOG_TIMESTAMP_H
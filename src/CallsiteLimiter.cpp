@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+
+#include "logger/CallsiteLimiter.h"
+
+namespace logger
+{
+
+static constexpr std::size_t kMaxProbes = 16;
+static constexpr int64_t kRepeatReportIntervalNs = 1'000'000'000;
+
+static int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+void CallsiteLimiter::configure(const Settings& settings)
+{
+    _isLimiting = false;
+    for (std::size_t k = 0; k < level::kCount; ++k) {
+        const RateLimit limit = settings.getRateLimit(static_cast<Level>(1 << k));
+
+        if (!limit.isEnabled()) {
+            _intervals[k] = 0;
+            _tolerances[k] = 0;
+            continue;
+        }
+        _intervals[k] = std::max<int64_t>(1'000'000'000 / limit.logsPerSecond, 1);
+        _tolerances[k] = (std::max<int64_t>(limit.burst, 1) - 1) * _intervals[k];
+        _isLimiting = true;
+    }
+    _isCollapsing = settings.isCollapsingRepeats();
+}
+
+CallsiteLimiter::Slot* CallsiteLimiter::find(const Callsite& site)
+{
+    const uint64_t key = combine(0, reinterpret_cast<uintptr_t>(&site));
+
+    for (std::size_t probe = 0; probe < kMaxProbes; ++probe) {
+        Slot& slot = _slots[(key + probe) & (kCapacity - 1)];
+        const Callsite* current = slot.site.load(std::memory_order_acquire);
+
+        if (current == nullptr && slot.site.compare_exchange_strong(current, &site, std::memory_order_acq_rel)) {
+            return &slot;
+        }
+        // on a failed claim, current is the call site of the thread that won it.
+        if (current == &site) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+bool CallsiteLimiter::admit(const Callsite& site, uint64_t& suppressed)
+{
+    const std::size_t index = level::toIndex(site.level);
+    const int64_t interval = _intervals[index];
+    Slot* slot = interval != 0 ? find(site) : nullptr;
+
+    suppressed = 0;
+    if (slot == nullptr) {
+        return true;
+    }
+
+    const int64_t now = nowNs();
+    int64_t fullAt = slot->fullAt.load(std::memory_order_relaxed);
+
+    // GCRA: the bucket is empty when it would take more than the burst to
+    // refill it.
+    do {
+        if (fullAt - now > _tolerances[index]) {
+            slot->suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!slot->fullAt.compare_exchange_weak(
+        fullAt,
+        std::max(fullAt, now) + interval,
+        std::memory_order_relaxed
+    ));
+
+    if (slot->suppressed.load(std::memory_order_relaxed) != 0) {
+        suppressed = slot->suppressed.exchange(0, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool CallsiteLimiter::collapse(const Callsite& site, const uint64_t hash, uint64_t& repeated)
+{
+    Slot* slot = find(site);
+
+    repeated = 0;
+    if (slot == nullptr) {
+        return false;
+    }
+
+    if (slot->lastHash.exchange(hash, std::memory_order_relaxed) != hash) {
+        if (slot->repeats.load(std::memory_order_relaxed) != 0) {
+            repeated = slot->repeats.exchange(0, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    const int64_t now = nowNs();
+
+    // long series of repeats are reported periodically, letting one through.
+    if (slot->repeats.load(std::memory_order_relaxed) != 0
+        && now - slot->reportedAt.load(std::memory_order_relaxed) >= kRepeatReportIntervalNs) {
+        repeated = slot->repeats.exchange(0, std::memory_order_relaxed);
+        return false;
+    }
+    if (slot->repeats.fetch_add(1, std::memory_order_relaxed) == 0) {
+        slot->reportedAt.store(now, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void CallsiteLimiter::drain(
+    const std::function<void(const Callsite&, uint64_t, uint64_t)>& report
+)
+{
+    for (Slot& slot : _slots) {
+        const Callsite* site = slot.site.load(std::memory_order_acquire);
+
+        if (site == nullptr) {
+            continue;
+        }
+
+        const uint64_t suppressed = slot.suppressed.exchange(0, std::memory_order_relaxed);
+        const uint64_t repeated = slot.repeats.exchange(0, std::memory_order_relaxed);
+
+        if (suppressed != 0 || repeated != 0) {
+            report(*site, suppressed, repeated);
+        }
+    }
+}
+
+}
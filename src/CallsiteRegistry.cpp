@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <string_view>
+
+#include "logger/CallsiteRegistry.h"
+
+namespace logger
+{
+
+/**
+ * @return  Whether a text matches a glob (@code *@endcode: any sequence,
+ *          @code ?@endcode: any character).
+ */
+static bool matchesGlob(const std::string_view glob, const std::string_view text)
+{
+    std::size_t g = 0;
+    std::size_t t = 0;
+    std::size_t star = std::string_view::npos;
+    std::size_t starText = 0;
+
+    while (t < text.size()) {
+        if (g < glob.size() && (glob[g] == '?' || glob[g] == text[t])) {
+            ++g;
+            ++t;
+        } else if (g < glob.size() && glob[g] == '*') {
+            star = g++;
+            starText = t;
+        } else if (star != std::string_view::npos) {
+            // the last star swallows one more character.
+            g = star + 1;
+            t = ++starText;
+        } else {
+            return false;
+        }
+    }
+    while (g < glob.size() && glob[g] == '*') {
+        ++g;
+    }
+    return g == glob.size();
+}
+
+/**
+ * @return  The qualified name of a function, from its signature
+ *          (e.g. "ns::Parser::parse" from "int ns::Parser::parse(int)").
+ */
+static std::string_view toQualifiedName(std::string_view function)
+{
+    function = function.substr(0, function.find('('));
+
+    const std::size_t space = function.rfind(' ');
+
+    return space == std::string_view::npos ? function : function.substr(space + 1);
+}
+
+/**
+ * @return  Whether a glob matches a name, or one of its trailing parts
+ *          (e.g. "Session::open" or "open" for "net::Session::open").
+ */
+static bool matchesName(const std::string_view glob, const std::string_view name, const std::string_view separator)
+{
+    std::size_t begin = 0;
+
+    while (!matchesGlob(glob, name.substr(begin))) {
+        begin = name.find(separator, begin);
+        if (begin == std::string_view::npos) {
+            return false;
+        }
+        begin += separator.size();
+    }
+    return true;
+}
+
+bool CallsiteFilter::matches(const Callsite& site) const
+{
+    return (levels & static_cast<uint16_t>(site.level)) != 0
+        && site.line >= firstLine
+        && site.line <= lastLine
+        && (file.empty() || matchesName(file, site.file, "/"))
+        && (function.empty() || matchesName(function, toQualifiedName(site.function), "::"));
+}
+
+CallsiteRegistry& CallsiteRegistry::getInstance()
+{
+    // never destroyed: logs may still point to their call site while static
+    // objects are torn down.
+    static CallsiteRegistry* instance = new CallsiteRegistry();
+    return *instance;
+}
+
+const Callsite& CallsiteRegistry::add(const Level level, const std::source_location& loc, std::atomic<bool>& enabled)
+{
+    std::lock_guard lock(_mutex);
+
+    return addLocked(level, loc, enabled);
+}
+
+const Callsite& CallsiteRegistry::addLocked(
+    const Level level,
+    const std::source_location& loc,
+    std::atomic<bool>& enabled
+)
+{
+    const Callsite& site = _sites.emplace_back(level, loc, enabled);
+
+    for (const auto& [filter, isEnabled] : _rules) {
+        if (filter.matches(site)) {
+            enabled.store(isEnabled, std::memory_order_relaxed);
+        }
+    }
+    return site;
+}
+
+const Callsite& CallsiteRegistry::intern(const Level level, const std::source_location& loc)
+{
+    // a thread usually logs from the same place over and over.
+    thread_local const Callsite* last = nullptr;
+
+    if (last != nullptr
+        && last->level == level
+        && last->file.data() == loc.file_name()
+        && last->function.data() == loc.function_name()
+        && last->line == loc.line()
+        && last->column == loc.column()) {
+        return *last;
+    }
+
+    std::lock_guard lock(_mutex);
+    const auto [it, isNew] = _interned.try_emplace(
+        Key{ loc.file_name(), loc.function_name(), loc.line(), loc.column(), level }
+    );
+
+    if (isNew) {
+        it->second = &addLocked(level, loc, _internedFlags.emplace_back(true));
+    }
+    last = it->second;
+    return *last;
+}
+
+std::size_t CallsiteRegistry::enable(const CallsiteFilter& filter)
+{
+    return apply(filter, true);
+}
+
+std::size_t CallsiteRegistry::disable(const CallsiteFilter& filter)
+{
+    return apply(filter, false);
+}
+
+std::size_t CallsiteRegistry::apply(const CallsiteFilter& filter, const bool isEnabled)
+{
+    std::lock_guard lock(_mutex);
+    std::size_t count = 0;
+
+    for (const Callsite& site : _sites) {
+        if (filter.matches(site) && site.enabled.exchange(isEnabled, std::memory_order_relaxed) != isEnabled) {
+            ++count;
+        }
+    }
+
+    // a rule replaces the previous one with the same filter, so that toggling
+    // a call site over and over doesn't pile rules up.
+    std::erase_if(_rules, [&](const auto& rule) { return rule.first == filter; });
+    _rules.emplace_back(filter, isEnabled);
+    return count;
+}
+
+void CallsiteRegistry::forEach(const std::function<void(const Callsite&)>& visit) const
+{
+    std::lock_guard lock(_mutex);
+
+    for (const Callsite& site : _sites) {
+        visit(site);
+    }
+}
+
+}
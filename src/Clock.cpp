@@ -0,0 +1,163 @@
+#include <atomic>
+#include <thread>
+
+#include "logger/Clock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SHUVLOG_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SHUVLOG_HAS_TSC 1
+#else
+#define SHUVLOG_HAS_TSC 0
+#endif
+
+namespace logger::clock
+{
+
+    using namespace std::chrono;
+
+    static std::atomic<ClockSource> source{ClockSource::kSystem};
+
+    /**
+     * Latest calibration, published through a sequence lock: readers retry
+     * if the sequence is odd (update in progress) or changed while reading.
+     * A wall-clock time is computed as
+     * @code baseWallNs + (ticks - baseTicks) * nsPerTick@endcode.
+     */
+    static std::atomic<uint32_t> sequence{0};
+    static std::atomic<uint64_t> baseTicks{0};
+    static std::atomic<int64_t> baseWallNs{0};
+    static std::atomic<double> nsPerTick{1.0};
+
+    /**
+     * First sample of the current source, used to measure the tick frequency
+     * over an ever-growing period. Only touched by the calibrating thread.
+     */
+    static uint64_t anchorTicks = 0;
+    static steady_clock::time_point anchorSteady;
+
+    static int64_t systemNowNs()
+    {
+        return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    static uint64_t readTicks(const ClockSource from)
+    {
+        switch (from)
+        {
+            case ClockSource::kSystem:
+                return static_cast<uint64_t>(systemNowNs());
+
+            case ClockSource::kSteady:
+                return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+
+            case ClockSource::kTsc:
+#if SHUVLOG_HAS_TSC
+                return __rdtsc();
+#else
+                return readTicks(ClockSource::kSteady);
+#endif
+        }
+        return 0;
+    }
+
+    static void publish(const uint64_t ticks, const int64_t wallNs, const double scale)
+    {
+        const uint32_t seq = sequence.load(std::memory_order_relaxed);
+
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        baseTicks.store(ticks, std::memory_order_relaxed);
+        baseWallNs.store(wallNs, std::memory_order_relaxed);
+        nsPerTick.store(scale, std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    void setSource(ClockSource newSource)
+    {
+#if !SHUVLOG_HAS_TSC
+        if (newSource == ClockSource::kTsc) {
+            newSource = ClockSource::kSteady;
+        }
+#endif
+        source.store(newSource, std::memory_order_relaxed);
+        anchorTicks = readTicks(newSource);
+        anchorSteady = steady_clock::now();
+
+        double scale = 1.0;
+
+        if (newSource == ClockSource::kTsc) {
+            // rough frequency estimate, refined by every calibrate() call.
+            while (steady_clock::now() - anchorSteady < milliseconds(5)) {
+                std::this_thread::yield();
+            }
+
+            const uint64_t ticks = readTicks(newSource);
+            const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - anchorSteady).count();
+
+            scale = static_cast<double>(elapsed) / static_cast<double>(ticks - anchorTicks);
+        }
+        publish(readTicks(newSource), systemNowNs(), scale);
+    }
+
+    ClockSource getSource()
+    {
+        return source.load(std::memory_order_relaxed);
+    }
+
+    uint64_t now()
+    {
+        return readTicks(source.load(std::memory_order_relaxed));
+    }
+
+    time_point<system_clock> toTimePoint(const uint64_t ticks)
+    {
+        if (source.load(std::memory_order_relaxed) == ClockSource::kSystem) {
+            return time_point<system_clock>(duration_cast<system_clock::duration>(nanoseconds(ticks)));
+        }
+
+        uint64_t base;
+        int64_t wallNs;
+        double scale;
+        uint32_t seq;
+
+        do {
+            seq = sequence.load(std::memory_order_acquire);
+            base = baseTicks.load(std::memory_order_relaxed);
+            wallNs = baseWallNs.load(std::memory_order_relaxed);
+            scale = nsPerTick.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) != 0 || seq != sequence.load(std::memory_order_relaxed));
+
+        // logs read before the latest calibration have a negative delta.
+        const auto delta = static_cast<int64_t>(ticks - base);
+        const auto ns = wallNs + static_cast<int64_t>(static_cast<double>(delta) * scale);
+
+        return time_point<system_clock>(duration_cast<system_clock::duration>(nanoseconds(ns)));
+    }
+
+    void calibrate()
+    {
+        const ClockSource current = source.load(std::memory_order_relaxed);
+
+        if (current == ClockSource::kSystem) {
+            return;
+        }
+
+        const int64_t wallNs = systemNowNs();
+        const uint64_t ticks = readTicks(current);
+        double scale = nsPerTick.load(std::memory_order_relaxed);
+
+        if (current == ClockSource::kTsc && ticks != anchorTicks) {
+            // measured against the steady clock, so that wall-clock jumps
+            // don't distort the frequency.
+            const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - anchorSteady).count();
+
+            scale = static_cast<double>(elapsed) / static_cast<double>(ticks - anchorTicks);
+        }
+        publish(ticks, wallNs, scale);
+    }
+
+}
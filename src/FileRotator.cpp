@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if SHUVLOG_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include "logger/FileRotator.h"
+#include "logger/Thread.h"
+#include "logger/Timestamp.h"
+
+namespace fs = std::filesystem;
+
+namespace logger
+{
+
+static constexpr std::string_view kGzipExtension = ".gz";
+
+FileRotator::FileRotator(
+    std::string activePath,
+    std::string extension,
+    const sink::RotationPolicy& policy,
+    const std::ios::openmode openMode
+)
+    : _activePath(std::move(activePath))
+    , _extension(std::move(extension))
+    , _nextPath(_activePath + ".next")
+    , _policy(policy)
+    , _openMode(openMode)
+    , _thread(&FileRotator::run, this)
+{}
+
+FileRotator::~FileRotator()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _isStopping = true;
+    }
+    _cvar.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    if (_nextFile) {
+        _nextFile->close();
+        std::error_code error;
+        fs::remove(_nextPath, error);
+    }
+}
+
+std::unique_ptr<std::fstream> FileRotator::takeNextFile()
+{
+    std::lock_guard lock(_mutex);
+
+    return std::move(_nextFile);
+}
+
+std::string FileRotator::makeRotatedPath()
+{
+    const std::string stem = _activePath.substr(0, _activePath.size() - _extension.size());
+    std::string timestamp = formatTimestamp(system_clock::now(), false, false, true);
+
+    // numbers are never reused within a second, even once retention deleted
+    // the file: they give the order of rotation.
+    int index = timestamp == _lastTimestamp ? _lastIndex + 1 : 0;
+    std::string path;
+
+    for (;; ++index) {
+        path = index == 0
+            ? std::format("{}.{}{}", stem, timestamp, _extension)
+            : std::format("{}.{}.{}{}", stem, timestamp, index, _extension);
+        if (!fs::exists(path) && !fs::exists(path + std::string(kGzipExtension))) {
+            break;
+        }
+    }
+    _lastTimestamp = std::move(timestamp);
+    _lastIndex = index;
+    return path;
+}
+
+void FileRotator::archive(std::string rotatedPath)
+{
+    {
+        std::lock_guard lock(_mutex);
+        _pending.push_back(std::move(rotatedPath));
+        _wantsNextFile = true;
+    }
+    _cvar.notify_one();
+}
+
+void FileRotator::run()
+{
+    setThreadLabel("FileRotator");
+
+    for (;;) {
+        std::string path;
+        bool wantsNextFile;
+
+        {
+            std::unique_lock lock(_mutex);
+
+            _cvar.wait(lock, [&] {
+                return _isStopping || _wantsNextFile || !_pending.empty();
+            });
+            if (_pending.empty() && (_isStopping || !_wantsNextFile)) {
+                break;
+            }
+            wantsNextFile = _wantsNextFile && !_isStopping && !_nextFile;
+            _wantsNextFile = false;
+            if (!_pending.empty()) {
+                path = std::move(_pending.front());
+                _pending.pop_front();
+            }
+        }
+
+        // the next file first: the writer may be waiting for it to rotate again.
+        if (wantsNextFile) {
+            auto file = std::make_unique<std::fstream>(_nextPath, _openMode);
+
+            if (file->is_open()) {
+                std::lock_guard lock(_mutex);
+                _nextFile = std::move(file);
+            }
+        }
+        if (!path.empty()) {
+            compress(path);
+            enforceRetention();
+        }
+    }
+}
+
+void FileRotator::compress(const std::string& path) const
+{
+#if SHUVLOG_HAS_ZLIB
+    if (_policy.compression != sink::Compression::kGzip) {
+        return;
+    }
+
+    const std::string compressedPath = path + std::string(kGzipExtension);
+    std::ifstream input(path, std::ios::binary);
+    gzFile output = gzopen(compressedPath.c_str(), "wb6");
+
+    if (!input || !output) {
+        if (output) {
+            gzclose(output);
+        }
+        return;
+    }
+
+    std::vector<char> chunk(64 * 1024);
+    bool isValid = true;
+
+    while (isValid && input) {
+        input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+
+        const auto count = static_cast<unsigned>(input.gcount());
+
+        isValid = count == 0 || gzwrite(output, chunk.data(), count) == static_cast<int>(count);
+    }
+    isValid = gzclose(output) == Z_OK && isValid;
+    input.close();
+
+    std::error_code error;
+
+    // the uncompressed file is only removed once its compressed copy is complete.
+    fs::remove(isValid ? path : compressedPath, error);
+#else
+    (void) path;
+#endif
+}
+
+void FileRotator::enforceRetention() const
+{
+    if (_policy.maxFiles == 0) {
+        return;
+    }
+
+    const fs::path active(_activePath);
+    const std::string stem = active.filename().string().substr(
+        0, active.filename().string().size() - _extension.size()
+    ) + ".";
+    std::vector<std::pair<std::pair<std::string, int>, fs::path>> rotated;
+    std::error_code error;
+
+    for (const auto& entry : fs::directory_iterator(active.parent_path(), error)) {
+        std::string name = entry.path().filename().string();
+
+        if (name.ends_with(kGzipExtension)) {
+            name.resize(name.size() - kGzipExtension.size());
+        }
+        if (!name.starts_with(stem) || !name.ends_with(_extension) || name.size() <= stem.size() + _extension.size()) {
+            continue;
+        }
+
+        // "<timestamp>" or "<timestamp>.<n>", as made by makeRotatedPath()
+        const std::string middle = name.substr(stem.size(), name.size() - stem.size() - _extension.size());
+        const std::string timestamp = middle.substr(0, middle.find('.'));
+        const int index = middle.size() > timestamp.size() ? std::atoi(middle.c_str() + timestamp.size() + 1) : 0;
+
+        if (timestamp.size() != 19 || !std::ranges::all_of(timestamp, [](const char c) {
+            return std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+        })) {
+            continue;
+        }
+        rotated.push_back({ { timestamp, index }, entry.path() });
+    }
+
+    if (rotated.size() <= _policy.maxFiles) {
+        return;
+    }
+    std::ranges::sort(rotated);
+    for (std::size_t k = 0; k + _policy.maxFiles < rotated.size(); ++k) {
+        fs::remove(rotated[k].second, error);
+    }
+}
+
+}
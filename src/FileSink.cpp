@@ -1,9 +1,12 @@
+#include <ctime>
 #include <filesystem>
+#include <system_error>
 
 #include "logger/FileSink.h"
 #include "logger/Exceptions/BadFileExtension.h"
 #include "logger/Exceptions/BadRecommendedExtension.h"
 #include "logger/Exceptions/CouldNotOpenFile.h"
+#include "logger/Timestamp.h"
 
 namespace logger
 {
@@ -34,6 +37,7 @@ FileSink::FileSink(
 )
     : Sink(filterMode, levelMask, settings)
     , _absoluteFilepath(std::filesystem::absolute(filepath).generic_string())
+    , _extension(recommendedExtension)
 {
     if (!recommendedExtension.starts_with(".") || recommendedExtension.length() < 2) {
         throw exception::BadRecommendedExtension(recommendedExtension);
@@ -43,10 +47,110 @@ FileSink::FileSink(
         throw exception::BadFileExtension(extensionName, recommendedExtension);
     }
 
-    _file.open(_absoluteFilepath, std::ios::in | std::ios::out | std::ios::trunc);
+    _file.open(_absoluteFilepath, _openMode);
     if (!_file.is_open()) {
         throw exception::CouldNotOpenFile(filepath);
     }
 }
 
+void FileSink::setRotationPolicy(const sink::RotationPolicy& policy)
+{
+    _rotationPolicy = policy;
+    _rotator.reset();
+    if (policy.isEnabled()) {
+        _rotator = std::make_unique<FileRotator>(_absoluteFilepath, _extension, policy, _openMode);
+        resetDeadlines();
+    }
+}
+
+void FileSink::writeToFile(const std::string_view data)
+{
+    _file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    _fileSize += data.size();
+}
+
+void FileSink::writeFileHeader(const std::string_view data)
+{
+    _header += data;
+    writeToFile(data);
+}
+
+void FileSink::seekFileBack(const std::streamoff count)
+{
+    _file.seekp(-count, std::ios::end);
+    _fileSize -= static_cast<std::size_t>(count);
+}
+
+void FileSink::rotateIfNeeded()
+{
+    if (!_rotator || !_file.is_open()) {
+        return;
+    }
+
+    // a file holding nothing but its header is never rotated.
+    if (_fileSize <= _header.size()) {
+        return;
+    }
+
+    const bool isFull = _rotationPolicy.maxBytes != 0 && _fileSize >= _rotationPolicy.maxBytes;
+    const bool isOld = _rotationPolicy.maxAgeSeconds != 0 && std::chrono::steady_clock::now() >= _ageDeadline;
+    const bool isNewDay = _rotationPolicy.isDaily && std::chrono::system_clock::now() >= _dailyDeadline;
+
+    if (isFull || isOld || isNewDay) {
+        rotate();
+    }
+}
+
+void FileSink::rotate()
+{
+    namespace fs = std::filesystem;
+
+    const std::string rotatedPath = _rotator->makeRotatedPath();
+    std::error_code error;
+
+    onFileClosing();
+    _file.close();
+    fs::rename(_absoluteFilepath, rotatedPath, error);
+    if (error) {
+        // carrying on in the same file, rather than losing it.
+        _file.open(_absoluteFilepath, (_openMode & ~std::ios::trunc) | std::ios::in | std::ios::ate);
+        resetDeadlines();
+        return;
+    }
+
+    // the next file is usually ready: it only has to take the active file's
+    // place. It is opened here otherwise.
+    const std::unique_ptr<std::fstream> next = _rotator->takeNextFile();
+
+    if (next) {
+        fs::rename(_rotator->getNextPath(), _absoluteFilepath, error);
+    }
+    if (next && !error) {
+        _file = std::move(*next);
+    } else {
+        _file.open(_absoluteFilepath, _openMode);
+    }
+
+    _fileSize = 0;
+    writeToFile(_header);
+    resetDeadlines();
+    onFileRotated();
+    _rotator->archive(rotatedPath);
+}
+
+void FileSink::resetDeadlines()
+{
+    const auto now = std::chrono::system_clock::now();
+    std::tm midnight = fromTimePoint(now);
+
+    midnight.tm_mday += 1;
+    midnight.tm_hour = 0;
+    midnight.tm_min = 0;
+    midnight.tm_sec = 0;
+    midnight.tm_isdst = -1;
+
+    _ageDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(_rotationPolicy.maxAgeSeconds);
+    _dailyDeadline = std::chrono::system_clock::from_time_t(std::mktime(&midnight));
+}
+
 }
@@ -0,0 +1,259 @@
+#include <array>
+#include <bit>
+#include <format>
+#include <iterator>
+
+#include "logger/JsonEncoder.h"
+#include "logger/OsInfo.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SHUVLOG_JSON_SIMD_WIDTH 32
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHUVLOG_JSON_SIMD_WIDTH 16
+#else
+#define SHUVLOG_JSON_SIMD_WIDTH 0
+#endif
+
+namespace logger::json
+{
+
+    static constexpr std::array<bool, 256> kNeedsEscape = [] {
+        std::array<bool, 256> table{};
+
+        for (std::size_t c = 0; c < 0x20; ++c) {
+            table[c] = true;
+        }
+        table['"'] = true;
+        table['\\'] = true;
+        return table;
+    }();
+
+    /**
+     * @return  The first character of [begin, end) that needs escaping, or
+     *          @code end@endcode.
+     */
+    static const char* findEscape(const char* begin, const char* const end)
+    {
+#if SHUVLOG_JSON_SIMD_WIDTH == 32
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control = _mm256_set1_epi8(0x1F);
+
+        for (; end - begin >= 32; begin += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            // max(c, 0x1F) == 0x1F  <=>  c <= 0x1F, unsigned
+            const __m256i special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+                _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control)
+            );
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+
+            if (mask != 0) {
+                return begin + std::countr_zero(mask);
+            }
+        }
+#endif
+#if SHUVLOG_JSON_SIMD_WIDTH >= 16
+        const __m128i quote16 = _mm_set1_epi8('"');
+        const __m128i backslash16 = _mm_set1_epi8('\\');
+        const __m128i control16 = _mm_set1_epi8(0x1F);
+
+        for (; end - begin >= 16; begin += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote16), _mm_cmpeq_epi8(chunk, backslash16)),
+                _mm_cmpeq_epi8(_mm_max_epu8(chunk, control16), control16)
+            );
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+
+            if (mask != 0) {
+                return begin + std::countr_zero(mask);
+            }
+        }
+#endif
+        for (; begin != end; ++begin) {
+            if (kNeedsEscape[static_cast<uint8_t>(*begin)]) {
+                break;
+            }
+        }
+        return begin;
+    }
+
+    void appendEscaped(std::string& out, const std::string_view value)
+    {
+        static constexpr char kHexDigits[] = "0123456789abcdef";
+
+        const char* begin = value.data();
+        const char* const end = begin + value.size();
+
+        while (begin != end) {
+            const char* special = findEscape(begin, end);
+
+            // clean runs are copied at once.
+            out.append(begin, special);
+            if (special == end) {
+                break;
+            }
+
+            switch (const char c = *special) {
+                case '"':   out += R"(\")"; break;
+                case '\\':  out += R"(\\)"; break;
+                case '\n':  out += R"(\n)"; break;
+                case '\r':  out += R"(\r)"; break;
+                case '\t':  out += R"(\t)"; break;
+                case '\b':  out += R"(\b)"; break;
+                case '\f':  out += R"(\f)"; break;
+                default: {
+                    const char escape[] = {
+                        '\\', 'u', '0', '0',
+                        kHexDigits[(c >> 4) & 0xF],
+                        kHexDigits[c & 0xF],
+                    };
+
+                    out.append(escape, sizeof(escape));
+                    break;
+                }
+            }
+            begin = special + 1;
+        }
+    }
+
+    /**
+     * @brief   Appends the members that come before the source of a log.
+     */
+    static void appendHead(std::string& out, const LogFields& log, TimestampRenderer& timestampRenderer)
+    {
+        out += R"({"timestamp":")";
+        timestampRenderer.renderTo(out, log.timestamp);
+        out += R"(","level":")";
+        out += level::to_string(log.level);
+        out += R"(","thread":{"name":")";
+        appendEscaped(out, log.threadName);
+        out += R"(","id":")";
+        appendEscaped(out, log.threadId);
+        out += R"("},)";
+    }
+
+    /**
+     * @brief   Appends the source members of a log, which only depend on its
+     *          call site.
+     */
+    static void appendSource(
+        std::string& out,
+        const std::string_view file,
+        const std::string_view function,
+        const uint64_t line,
+        const uint64_t column
+    )
+    {
+        out += R"("source":")";
+        appendEscaped(out, file);
+        out += R"(","functionName":")";
+        appendEscaped(out, function);
+        std::format_to(std::back_inserter(out),
+            R"(","line":{},"column":{},)",
+            line, column
+        );
+    }
+
+    /**
+     * @brief   Appends the members that come after the source of a log.
+     */
+    static void appendTail(std::string& out, const LogFields& log)
+    {
+        out += R"("message":")";
+        appendEscaped(out, log.message);
+        out += '"';
+        // only for sampled logs, which stand for that many logs.
+        if (log.sampleRate > 1) {
+            std::format_to(std::back_inserter(out), R"(,"sampleRate":{})", log.sampleRate);
+        }
+        out += '}';
+    }
+
+    void appendLog(std::string& out, const LogFields& log, TimestampRenderer& timestampRenderer)
+    {
+        appendHead(out, log, timestampRenderer);
+        appendSource(out, log.file, log.function, log.line, log.column);
+        appendTail(out, log);
+    }
+
+    void appendLog(std::string& out, const Log& log, TimestampRenderer& timestampRenderer)
+    {
+        appendLog(out, LogFields::from(log), timestampRenderer);
+    }
+
+    void appendLog(
+        std::string& out,
+        const Log& log,
+        TimestampRenderer& timestampRenderer,
+        CallsiteCache& sources
+    )
+    {
+        const LogFields fields = LogFields::from(log);
+
+        appendHead(out, fields, timestampRenderer);
+        out += sources.get(log.getCallsite(), [&](std::string& source) {
+            appendSource(source, fields.file, fields.function, fields.line, fields.column);
+        });
+        appendTail(out, fields);
+    }
+
+    void appendHeaderFields(
+        std::string& out,
+        const std::string& projectName,
+        const int argc,
+        const char* argv[],
+        const BuildInfo& buildInfo,
+        const sink::FilterMode filterMode,
+        const std::vector<Level>& levelMask
+    )
+    {
+        const std::string command = sink::toCommand(argc, argv);
+
+        out += R"("projectName":)";
+        appendString(out, projectName);
+        out += R"(,"version":)";
+        appendString(out, buildInfo.getVersion());
+        out += R"(,"buildType":)";
+        appendString(out, buildInfo.getType());
+
+        out += R"(,"filterMode":)";
+        appendString(out, sink::filter::to_string(filterMode));
+        out += R"(,"levelMask":)";
+
+        if (filterMode == sink::FilterMode::kExplicit) {
+            out += '[';
+            for (const Level level : levelMask) {
+                appendString(out, level::to_string(level));
+                out += ',';
+            }
+            if (out.back() == ',') {
+                out.pop_back();
+            }
+            out += ']';
+        } else if (!levelMask.empty()) {
+            appendString(out, level::to_string(levelMask.front()));
+        } else {
+            out += R"("")";
+        }
+
+        out += R"(,"command":)";
+        appendString(out, command);
+        out += R"(,"startTime":)";
+        appendString(out, formatTimestamp(system_clock::now()));
+        out += R"(,"osName":)";
+        appendString(out, osname());
+        out += R"(,"kernelVersion":)";
+        appendString(out, kernelver());
+        out += R"(,"compiler":)";
+        appendString(out, buildInfo.getCompiler());
+        out += R"(,"compilationFlags":)";
+        appendString(out, buildInfo.getCompilerFlags());
+        out += R"(,"buildSystem":)";
+        appendString(out, buildInfo.getBuildSystem());
+    }
+
+}
@@ -1,15 +1,188 @@
-#include "logger/Logger.h"
+#include <cstring>
+#include <string>
+
+#include "logger/Clock.h"
+#include "logger/Log.h"
+#include "logger/LogArena.h"
 #include "logger/Thread.h"
 
 Log::Log(
-    std::string message,
-    const logger::Level level,
-    const std::source_location& loc
+    const std::string_view message,
+    const logger::Callsite& site,
+    logger::LogArena* arena,
+    const uint32_t sampleRate
+)
+    : _timestamp(logger::clock::now())
+    , _site(&site)
+    , _threadIndex(logger::getThreadIndex())
+    , _sampleRate(sampleRate)
+{
+    storeMessage(message, arena);
+}
+
+Log::Log(
+    logger::DeferredMessage message,
+    const logger::Callsite& site,
+    const uint32_t sampleRate
 )
-    : _message(std::move(message))
-    , _level(level)
-    , _location(loc)
-    , _threadId(std::this_thread::get_id())
-    , _threadName(logger::getThreadLabel())
-    , _timestamp(std::chrono::system_clock::now())
-{}
+    : _timestamp(logger::clock::now())
+    , _site(&site)
+    , _threadIndex(logger::getThreadIndex())
+    , _sampleRate(sampleRate)
+    , _storage(Storage::kDeferred)
+{
+    new (&_payload.deferred) logger::DeferredMessage(std::move(message));
+}
+
+Log::Log(
+    const std::string_view message,
+    const logger::Callsite& site,
+    const uint64_t timestamp,
+    const uint32_t threadIndex,
+    const uint32_t sampleRate
+)
+    : _timestamp(timestamp)
+    , _site(&site)
+    , _threadIndex(threadIndex)
+    , _sampleRate(sampleRate)
+{
+    storeMessage(message, nullptr);
+}
+
+Log::Log(Log&& other) noexcept
+{
+    moveFrom(other);
+}
+
+Log& Log::operator=(Log&& other) noexcept
+{
+    if (this != &other) {
+        releaseMessage();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+Log::~Log()
+{
+    releaseMessage();
+}
+
+void Log::resolveMessage(logger::LogArena* arena)
+{
+    if (_storage != Storage::kDeferred) {
+        return;
+    }
+
+    // reused from one log to the next, so that rendering doesn't allocate
+    // once the buffer has grown to the longest message.
+    thread_local std::string message;
+
+    message.clear();
+    _payload.deferred.renderTo(message);
+    releaseMessage();
+    storeMessage(message, arena);
+}
+
+std::string_view Log::getMessage() const
+{
+    switch (_storage)
+    {
+        case Storage::kInline:
+            return { _payload.text, _messageSize };
+
+        case Storage::kHeap:
+        case Storage::kArena:
+            return { _payload.heap, _messageSize };
+
+        case Storage::kDeferred:
+            return {};
+    }
+    return {};
+}
+
+std::chrono::time_point<std::chrono::system_clock> Log::getTimestamp() const
+{
+    return logger::clock::toTimePoint(_timestamp);
+}
+
+std::size_t Log::getFootprint() const
+{
+    if (_storage == Storage::kHeap || _storage == Storage::kArena) {
+        return sizeof(Log) + _messageSize;
+    }
+    return sizeof(Log);
+}
+
+void Log::storeMessage(const std::string_view message, logger::LogArena* arena)
+{
+    _messageSize = static_cast<uint32_t>(message.size());
+
+    if (message.size() <= kInlineCapacity) {
+        _storage = Storage::kInline;
+        std::memcpy(_payload.text, message.data(), message.size());
+        return;
+    }
+
+    if (void* memory = arena ? arena->allocate(message.size()) : nullptr) {
+        _storage = Storage::kArena;
+        _payload.heap = static_cast<char*>(memory);
+    } else {
+        _storage = Storage::kHeap;
+        _payload.heap = new char[message.size()];
+    }
+    std::memcpy(_payload.heap, message.data(), message.size());
+}
+
+void Log::moveFrom(Log& other) noexcept
+{
+    _timestamp = other._timestamp;
+    _site = other._site;
+    _messageSize = other._messageSize;
+    _threadIndex = other._threadIndex;
+    _sampleRate = other._sampleRate;
+    _storage = other._storage;
+
+    switch (_storage)
+    {
+        case Storage::kInline:
+            std::memcpy(_payload.text, other._payload.text, _messageSize);
+            break;
+
+        case Storage::kHeap:
+        case Storage::kArena:
+            _payload.heap = other._payload.heap;
+            break;
+
+        case Storage::kDeferred:
+            new (&_payload.deferred) logger::DeferredMessage(std::move(other._payload.deferred));
+            other._payload.deferred.~DeferredMessage();
+            break;
+    }
+    // other is left with an empty inline message, so that it owns nothing.
+    other._storage = Storage::kInline;
+    other._messageSize = 0;
+}
+
+void Log::releaseMessage()
+{
+    switch (_storage)
+    {
+        case Storage::kInline:
+            break;
+
+        case Storage::kHeap:
+            delete[] _payload.heap;
+            break;
+
+        case Storage::kArena:
+            logger::LogArena::release(_payload.heap);
+            break;
+
+        case Storage::kDeferred:
+            _payload.deferred.~DeferredMessage();
+            break;
+    }
+    _storage = Storage::kInline;
+    _messageSize = 0;
+}
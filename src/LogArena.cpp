@@ -0,0 +1,189 @@
+#include <mutex>
+#include <new>
+
+#include "logger/LogArena.h"
+
+namespace logger
+{
+
+struct alignas(64) LogArena::Slab
+{
+    Pool* pool;
+    Slab* next = nullptr;
+
+    /**
+     * Number of allocations not released yet, minus the ones still being
+     * counted by the producer. Starts at 0, only goes down while the slab is
+     * in use (releases), and the producer adds its allocation count when
+     * retiring the slab: whoever brings it back to exactly 0 recycles it.
+     */
+    std::atomic<std::int64_t> outstanding{0};
+
+    explicit Slab(Pool* pool) : pool(pool) {}
+
+    std::byte* data() { return reinterpret_cast<std::byte*>(this) + sizeof(Slab); }
+};
+
+static constexpr std::size_t SLAB_CAPACITY = LogArena::kSlabSize - 64;
+
+/**
+ * Slabs of an arena. Outlives the arena as long as some of its slabs are in
+ * use, so that they can still be released.
+ */
+struct LogArena::Pool
+{
+    std::mutex mutex;
+    Slab* freeList = nullptr;
+    std::size_t slabCount = 0;  // allocated so far, in use or recycled
+    std::size_t inUse = 0;      // out of the free list
+    bool isClosed = false;      // the arena has been destroyed
+};
+
+static void destroySlab(void* slab)
+{
+    ::operator delete(slab, std::align_val_t{LogArena::kSlabSize});
+}
+
+/**
+ * Slab a thread is currently allocating from.
+ */
+struct LogArena::Cursor
+{
+    Slab* slab = nullptr;
+    std::size_t offset = 0;
+    std::int64_t allocated = 0;
+
+    ~Cursor()
+    {
+        if (slab) {
+            retire(slab, allocated);
+        }
+        // an allocation performed after this point (e.g. from another
+        // thread_local destructor) starts a new slab instead of reusing this one.
+        slab = nullptr;
+    }
+};
+
+LogArena::LogArena()
+    : _pool(new Pool())
+{}
+
+LogArena::~LogArena()
+{
+    bool isUnused;
+
+    {
+        std::lock_guard lock(_pool->mutex);
+
+        while (Slab* slab = _pool->freeList) {
+            _pool->freeList = slab->next;
+            slab->~Slab();
+            destroySlab(slab);
+        }
+        // threads that outlive the arena free the slabs they still use.
+        _pool->isClosed = true;
+        isUnused = _pool->inUse == 0;
+    }
+    if (isUnused) {
+        delete _pool;
+    }
+}
+
+void* LogArena::allocate(std::size_t size)
+{
+    static thread_local Cursor cursor;
+
+    if (size > kMaxAllocation) {
+        return nullptr;
+    }
+
+    // keeping allocations pointer-aligned
+    size = (size + alignof(void*) - 1) & ~(alignof(void*) - 1);
+
+    if (cursor.slab && (cursor.slab->pool != _pool || cursor.offset + size > SLAB_CAPACITY)) {
+        retire(cursor.slab, cursor.allocated);
+        cursor.slab = nullptr;
+    }
+    if (!cursor.slab) {
+        cursor.slab = acquireSlab();
+        cursor.offset = 0;
+        cursor.allocated = 0;
+    }
+
+    void* ptr = cursor.slab->data() + cursor.offset;
+
+    cursor.offset += size;
+    ++cursor.allocated;
+    return ptr;
+}
+
+void LogArena::release(void* ptr)
+{
+    // slabs are aligned on their size: the header is at the start of the
+    // slab the pointer belongs to.
+    auto* slab = reinterpret_cast<Slab*>(
+        reinterpret_cast<std::uintptr_t>(ptr) & ~(static_cast<std::uintptr_t>(kSlabSize) - 1)
+    );
+
+    if (slab->outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        recycle(slab);
+    }
+}
+
+std::size_t LogArena::getSlabCount() const
+{
+    std::lock_guard lock(_pool->mutex);
+    return _pool->slabCount;
+}
+
+LogArena::Slab* LogArena::acquireSlab()
+{
+    std::lock_guard lock(_pool->mutex);
+
+    ++_pool->inUse;
+    if (_pool->freeList) {
+        Slab* slab = _pool->freeList;
+
+        _pool->freeList = slab->next;
+        slab->next = nullptr;
+        return slab;
+    }
+
+    void* memory = ::operator new(kSlabSize, std::align_val_t{kSlabSize});
+
+    ++_pool->slabCount;
+    return new (memory) Slab(_pool);
+}
+
+void LogArena::recycle(Slab* slab)
+{
+    Pool* pool = slab->pool;
+    bool isUnused = false;
+
+    {
+        std::lock_guard lock(pool->mutex);
+
+        --pool->inUse;
+        if (!pool->isClosed) {
+            slab->next = pool->freeList;
+            pool->freeList = slab;
+            return;
+        }
+        slab->~Slab();
+        destroySlab(slab);
+        isUnused = pool->inUse == 0;
+    }
+    // the last slab of a destroyed arena takes the pool with it.
+    if (isUnused) {
+        delete pool;
+    }
+}
+
+void LogArena::retire(Slab* slab, std::int64_t allocated)
+{
+    if (slab->outstanding.fetch_add(allocated, std::memory_order_acq_rel) + allocated == 0) {
+        recycle(slab);
+    }
+}
+
+}
@@ -0,0 +1,419 @@
+#include <algorithm>
+
+#include "logger/LogQueue.h"
+
+namespace logger
+{
+
+ThreadLogBufferHandle::~ThreadLogBufferHandle()
+{
+    if (buffer) {
+        buffer->closed.store(true, std::memory_order_release);
+    }
+    // a log performed after this point (e.g. from another thread_local
+    // destructor) registers a brand-new buffer instead of reusing this one.
+    buffer = nullptr;
+}
+
+void LogQueue::configure(const Settings& settings)
+{
+    _backend = settings.getQueueBackend();
+
+    if (_backend == QueueBackend::kLockFree) {
+        _ringBuffer = std::make_unique<MpscRingBuffer<Log>>(settings.getQueueCapacity());
+    }
+    _threadBufferCapacity = settings.getThreadBufferCapacity();
+
+    _overflowPolicy = settings.getOverflowPolicy();
+    // a producer can only pop from its own buffer, not the other threads' ones.
+    if (_backend == QueueBackend::kPerThread && _overflowPolicy == OverflowPolicy::kDropOldest) {
+        _overflowPolicy = OverflowPolicy::kDropNewest;
+    }
+    _maxLogs = settings.getMaxQueuedLogs();
+    _maxBytes = settings.getMaxQueuedBytes();
+    _isBounded = _maxLogs != 0 || _maxBytes != 0;
+}
+
+void LogQueue::push(Log log)
+{
+    const std::size_t footprint = log.getFootprint();
+    std::optional<std::uint64_t> roomVersion;
+
+    for (;;) {
+        if (reserve(footprint)) {
+            if (tryPush(log)) {
+                // the mutex backend notifies the worker on its own.
+                if (_backend != QueueBackend::kMutex) {
+                    wakeConsumer();
+                }
+                break;
+            }
+            unreserve(footprint);
+        }
+        if (!handleOverflow(log, roomVersion)) {
+            break;
+        }
+    }
+    if (roomVersion) {
+        _roomWaiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+std::optional<Log> LogQueue::pop()
+{
+    std::optional<Log> log = popFromBackend();
+
+    if (log) {
+        unreserve(log->getFootprint());
+        releaseRoom();
+    }
+    return log;
+}
+
+std::size_t LogQueue::size() const
+{
+    switch (_backend)
+    {
+        case QueueBackend::kMutex:
+            return _lockedQueue.size();
+
+        case QueueBackend::kLockFree:
+            return _ringBuffer->size();
+
+        case QueueBackend::kPerThread: {
+            std::lock_guard lock(_threadBuffersMutex);
+            std::size_t total = 0;
+
+            for (const auto& buffer : _threadBuffers) {
+                total += buffer->ring.size();
+            }
+            return total;
+        }
+    }
+    return 0;
+}
+
+void LogQueue::waitForData(
+    std::chrono::milliseconds timeout,
+    const std::atomic<bool>& runningFlag
+)
+{
+    if (_backend == QueueBackend::kMutex) {
+        _lockedQueue.waitForData(timeout, runningFlag);
+        return;
+    }
+
+    std::unique_lock lock(_wakeMutex);
+
+    // announcing that we're going to sleep *before* checking for data, so
+    // that a producer pushing in-between can't miss us (see wakeConsumer()).
+    _consumerWaiting.store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    _wakeCvar.wait_for(lock, timeout, [&] {
+        return hasData() || !runningFlag.load();
+    });
+
+    _consumerWaiting.store(false, std::memory_order_relaxed);
+}
+
+void LogQueue::drainTo(std::vector<Log>& out)
+{
+    if (_backend == QueueBackend::kMutex) {
+        const std::size_t first = out.size();
+
+        _lockedQueue.drainTo(out);
+        for (std::size_t k = first; k < out.size(); ++k) {
+            unreserve(out[k].getFootprint());
+        }
+        if (out.size() != first) {
+            releaseRoom();
+        }
+        return;
+    }
+
+    while (std::optional<Log> log = pop()) {
+        out.emplace_back(std::move(*log));
+    }
+}
+
+void LogQueue::notifyAll()
+{
+    if (_backend == QueueBackend::kMutex) {
+        _lockedQueue.notifyAll();
+        return;
+    }
+
+    {
+        std::lock_guard lock(_wakeMutex);
+    } // makes sure the worker is either before its predicate check or waiting.
+    _wakeCvar.notify_all();
+}
+
+void LogQueue::close()
+{
+    _isClosed.store(true, std::memory_order_release);
+
+    {
+        std::lock_guard lock(_roomMutex);
+    } // waiting producers are either before their predicate check or waiting.
+    _roomCvar.notify_all();
+}
+
+std::uint64_t LogQueue::getDroppedCount(const Level level) const
+{
+    return _dropped[level::toIndex(level)].load(std::memory_order_relaxed);
+}
+
+bool LogQueue::tryPush(Log& log)
+{
+    switch (_backend)
+    {
+        case QueueBackend::kMutex:
+            _lockedQueue.push(std::move(log));
+            return true;
+
+        case QueueBackend::kLockFree:
+            return _ringBuffer->tryPush(std::move(log));
+
+        case QueueBackend::kPerThread:
+            return localBuffer().ring.tryPush(std::move(log));
+    }
+    return false;
+}
+
+std::optional<Log> LogQueue::popFromBackend()
+{
+    switch (_backend)
+    {
+        case QueueBackend::kMutex:
+            return _lockedQueue.pop();
+
+        case QueueBackend::kLockFree:
+            return _ringBuffer->pop();
+
+        case QueueBackend::kPerThread:
+            return popFromThreadBuffers();
+    }
+    return std::nullopt;
+}
+
+bool LogQueue::handleOverflow(const Log& log, std::optional<std::uint64_t>& roomVersion)
+{
+    OverflowPolicy policy = _overflowPolicy;
+
+    if (policy == OverflowPolicy::kDropByLevel) {
+        policy = static_cast<uint16_t>(log.getLevel()) < static_cast<uint16_t>(Level::kWarning)
+            ? OverflowPolicy::kDropNewest
+            : OverflowPolicy::kBlock;
+    }
+    // nobody will release any room once the worker is stopping.
+    if (policy == OverflowPolicy::kBlock && _isClosed.load(std::memory_order_acquire)) {
+        policy = OverflowPolicy::kDropNewest;
+    }
+
+    switch (policy)
+    {
+        case OverflowPolicy::kDropNewest:
+            recordDrop(log.getLevel());
+            return false;
+
+        case OverflowPolicy::kDropOldest:
+            // if the worker emptied the queue in-between, there's simply room again.
+            if (std::optional<Log> oldest = pop()) {
+                recordDrop(oldest->getLevel());
+            }
+            return true;
+
+        case OverflowPolicy::kBlock:
+        case OverflowPolicy::kDropByLevel:
+            // make sure the worker is awake, it is the one releasing room.
+            wakeConsumer();
+            if (!roomVersion) {
+                // announcing that we're waiting *before* trying again, so
+                // that a pop in-between can't miss us (see releaseRoom()).
+                _roomWaiters.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                roomVersion = _roomVersion.load(std::memory_order_acquire);
+                return true;
+            }
+            roomVersion = waitForRoom(*roomVersion);
+            return true;
+    }
+    return true;
+}
+
+bool LogQueue::reserve(const std::size_t footprint)
+{
+    if (!_isBounded) {
+        return true;
+    }
+
+    const std::size_t logs = _queuedLogs.fetch_add(1, std::memory_order_relaxed) + 1;
+    const std::size_t bytes = _queuedBytes.fetch_add(footprint, std::memory_order_relaxed) + footprint;
+
+    // an empty queue always accepts a log, however big it is.
+    if (logs > 1 && ((_maxLogs != 0 && logs > _maxLogs) || (_maxBytes != 0 && bytes > _maxBytes))) {
+        unreserve(footprint);
+        return false;
+    }
+    return true;
+}
+
+void LogQueue::unreserve(const std::size_t footprint)
+{
+    if (!_isBounded) {
+        return;
+    }
+    _queuedLogs.fetch_sub(1, std::memory_order_relaxed);
+    _queuedBytes.fetch_sub(footprint, std::memory_order_relaxed);
+}
+
+std::uint64_t LogQueue::waitForRoom(const std::uint64_t roomVersion)
+{
+    std::unique_lock lock(_roomMutex);
+
+    _roomCvar.wait(lock, [&] {
+        return _roomVersion.load(std::memory_order_relaxed) != roomVersion
+            || _isClosed.load(std::memory_order_acquire);
+    });
+    return _roomVersion.load(std::memory_order_relaxed);
+}
+
+void LogQueue::releaseRoom()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // fast path: no producer is waiting for room.
+    if (_roomWaiters.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(_roomMutex);
+        _roomVersion.fetch_add(1, std::memory_order_relaxed);
+    }
+    _roomCvar.notify_all();
+}
+
+void LogQueue::recordDrop(const Level level)
+{
+    _dropped[level::toIndex(level)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogQueue::wakeConsumer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // fast path: worker is busy, nobody to wake up.
+    if (!_consumerWaiting.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // only the first producer to see the worker sleeping pays for the wake up.
+    if (!_consumerWaiting.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(_wakeMutex);
+    } // worker is either before its predicate check (and will see the data) or waiting.
+    _wakeCvar.notify_one();
+}
+
+ThreadLogBuffer& LogQueue::localBuffer()
+{
+    ThreadLogBufferHandle& handle = threadLogBuffer;
+
+    if (handle.buffer) {
+        return *handle.buffer;
+    }
+
+    auto buffer = std::make_unique<ThreadLogBuffer>(_threadBufferCapacity);
+    ThreadLogBuffer* raw = buffer.get();
+
+    {
+        std::lock_guard lock(_threadBuffersMutex);
+        _threadBuffers.push_back(std::move(buffer));
+    }
+    _threadBuffersVersion.fetch_add(1, std::memory_order_release);
+
+    handle.buffer = raw;
+    return *raw;
+}
+
+std::optional<Log> LogQueue::popFromThreadBuffers()
+{
+    // refreshing our snapshot only when a thread registered or a buffer has
+    // been released, so that the common path never takes the lock.
+    if (const auto version = _threadBuffersVersion.load(std::memory_order_acquire);
+        version != _drainVersion) {
+        std::lock_guard lock(_threadBuffersMutex);
+
+        _drainOrder.clear();
+        for (const auto& buffer : _threadBuffers) {
+            _drainOrder.push_back(buffer.get());
+        }
+        _drainVersion = version;
+    }
+
+    const std::size_t count = _drainOrder.size();
+    bool hasClosedBuffer = false;
+
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::size_t index = (_drainCursor + k) % count;
+        ThreadLogBuffer* buffer = _drainOrder[index];
+
+        // reading the flag before popping: if it's set, the owning thread
+        // won't push anymore, so an empty buffer will stay empty.
+        const bool closed = buffer->closed.load(std::memory_order_acquire);
+
+        if (std::optional<Log> log = buffer->ring.pop()) {
+            // next pop starts with the following thread, whatever happens.
+            _drainCursor = index + 1;
+            return log;
+        }
+        hasClosedBuffer |= closed;
+    }
+
+    if (hasClosedBuffer) {
+        releaseClosedBuffers();
+    }
+    return std::nullopt;
+}
+
+void LogQueue::releaseClosedBuffers()
+{
+    {
+        std::lock_guard lock(_threadBuffersMutex);
+
+        std::erase_if(_threadBuffers, [](const std::unique_ptr<ThreadLogBuffer>& buffer) {
+            return buffer->closed.load(std::memory_order_acquire) && buffer->ring.empty();
+        });
+    }
+    _drainOrder.clear();
+    _drainCursor = 0;
+    _threadBuffersVersion.fetch_add(1, std::memory_order_release);
+}
+
+bool LogQueue::hasData()
+{
+    switch (_backend)
+    {
+        case QueueBackend::kMutex:
+            return false;
+
+        case QueueBackend::kLockFree:
+            return !_ringBuffer->empty();
+
+        case QueueBackend::kPerThread: {
+            std::lock_guard lock(_threadBuffersMutex);
+
+            return std::ranges::any_of(_threadBuffers, [](const std::unique_ptr<ThreadLogBuffer>& buffer) {
+                return !buffer->ring.empty();
+            });
+        }
+    }
+    return false;
+}
+
+}
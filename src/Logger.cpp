@@ -1,9 +1,10 @@
+#include <algorithm>
 #include <filesystem>
 #include <chrono>
 #include <iostream>
 #include <format>
-#include <unordered_set>
 
+#include "logger/Clock.h"
 #include "logger/Logger.h"
 #include "logger/Thread.h"
 #include "logger/Timestamp.h"
@@ -13,6 +14,22 @@ namespace fs = std::filesystem;
 std::once_flag Logger::initFlag;
 
 static const std::string LOG_DIR = "logs";
+static constexpr auto CLOCK_CALIBRATION_INTERVAL = std::chrono::seconds(1);
+
+/**
+ * @brief   Low-level logs held back by the calling thread, until it logs an
+ *          error (see @code logger::Settings::setBacktrace()@endcode).
+ *
+ * A ring: once full, @code next@endcode is the oldest log, the one
+ * overwritten by the next log held back.
+ */
+struct Backtrace
+{
+    std::vector<Log> logs;
+    std::size_t next = 0;
+};
+
+static thread_local Backtrace threadBacktrace;
 
 Logger& Logger::getInstance()
 {
@@ -41,14 +58,24 @@ void Logger::initialize(
         instance._buildInfo = buildInfo;
         instance._argc = argc;
         instance._argv = argv;
+        instance._queue.configure(instance._settings);
+        instance._callsites.configure(instance._settings);
+        logger::clock::setSource(instance._settings.getClockSource());
 
         if (!fs::exists(LOG_DIR)) {
             fs::create_directories(LOG_DIR);
         }
 
-        for (const auto& sink : instance._sinks) {
-            sink->writeHeader(instance._projectName, argc, argv, buildInfo, instance._settings);
+        std::lock_guard lock(instance._sinkMutex);
+        logger::SinkRegistry::Snapshot sinks = instance._sinkRegistry.current();
+
+        for (auto& entry : sinks.entries) {
+            entry.sink->writeHeader(instance._projectName, argc, argv, buildInfo, instance._settings);
+            if (instance._settings.isThreadPerSink()) {
+                entry.worker = std::make_shared<logger::SinkWorker>(entry.sink);
+            }
         }
+        instance._sinkRegistry.publish(std::move(sinks));
 
         instance._isRunning = true;
         instance._isInitialized = true;
@@ -56,59 +83,275 @@ void Logger::initialize(
     });
 }
 
-void Logger::log(
-    logger::Level level,
-    const std::source_location& loc,
-    const std::string_view message
-)
+bool Logger::canLog() const
 {
     if (!_isInitialized) {
         std::cerr << "CAUTION: Logger has been used uninitialized.\n"
                   << "Make sure you call the initialize() function before performing any log."
                   << std::endl;
-        return;
+        return false;
     }
 
-    if (_sinks.empty()) {
+    if (_sinkRegistry.empty()) {
         std::cerr << "WARNING: Trying to log with no sink."
                   << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Logger::log(const logger::Callsite& site, const std::string_view message)
+{
+    if (!site.isEnabled() || !isLevelEnabled(site.level) || !admit(site)) {
+        return;
+    }
+    if (_callsites.isCollapsing() && isRepeat(site, logger::CallsiteLimiter::hashMessage(message))) {
+        return;
+    }
+    submit(site, message);
+}
+
+void Logger::log(
+    const logger::Level level,
+    const std::source_location& loc,
+    const std::string_view message
+)
+{
+    if (isLevelEnabled(level)) {
+        log(logger::CallsiteRegistry::getInstance().intern(level, loc), message);
+    }
+}
+
+void Logger::log(const logger::Callsite& site, logger::DeferredMessage message)
+{
+    if (!site.isEnabled() || !isLevelEnabled(site.level) || !admit(site)) {
+        return;
+    }
+    submit(site, std::move(message));
+}
+
+void Logger::log(
+    const logger::Level level,
+    const std::source_location& loc,
+    logger::DeferredMessage message
+)
+{
+    if (isLevelEnabled(level)) {
+        log(logger::CallsiteRegistry::getInstance().intern(level, loc), std::move(message));
+    }
+}
+
+bool Logger::isRepeat(const logger::Callsite& site, const uint64_t hash)
+{
+    uint64_t repeated = 0;
+
+    if (_callsites.collapse(site, hash, repeated)) {
+        return true;
+    }
+    if (repeated != 0) {
+        submit(site, std::format("Last message repeated {} times.", repeated));
+    }
+    return false;
+}
+
+void Logger::submit(
+    const logger::Callsite& site,
+    const std::string_view message,
+    const uint32_t sampleRate
+)
+{
+    if (!canLog()) {
+        return;
+    }
+
+    // held back logs may wait for a long time: not pinning arena slabs.
+    if (isBacktraced(site.level)) {
+        holdBack(Log{ message, site, nullptr, sampleRate });
+        return;
+    }
+    enqueue(Log{ message, site, &_arena, sampleRate });
+}
+
+void Logger::submit(
+    const logger::Callsite& site,
+    logger::DeferredMessage message,
+    const uint32_t sampleRate
+)
+{
+    if (!canLog()) {
+        return;
+    }
+
+    if (isBacktraced(site.level)) {
+        holdBack(Log{ std::move(message), site, sampleRate });
+        return;
+    }
+    enqueue(Log{ std::move(message), site, sampleRate });
+}
+
+void Logger::holdBack(Log log)
+{
+    const std::size_t depth = _settings.getBacktraceDepth();
+
+    if (threadBacktrace.logs.size() < depth) {
+        threadBacktrace.logs.push_back(std::move(log));
+        return;
+    }
+    threadBacktrace.logs[threadBacktrace.next] = std::move(log);
+    threadBacktrace.next = (threadBacktrace.next + 1) % threadBacktrace.logs.size();
+}
+
+void Logger::enqueue(Log log)
+{
+    const bool isTrigger = static_cast<uint16_t>(log.getLevel())
+        >= static_cast<uint16_t>(_settings.getBacktraceTrigger());
+
+    if (isTrigger && !threadBacktrace.logs.empty()) {
+        const std::size_t size = threadBacktrace.logs.size();
+
+        // oldest first
+        for (std::size_t k = 0; k < size; ++k) {
+            _queue.push(std::move(threadBacktrace.logs[(threadBacktrace.next + k) % size]));
+        }
+        threadBacktrace.logs.clear();
+        threadBacktrace.next = 0;
+    }
+    _queue.push(std::move(log));
+}
+
+void Logger::setSinkFilter(
+    const std::shared_ptr<logger::Sink>& sink,
+    logger::sink::FilterMode filterMode,
+    uint16_t levelMask
+)
+{
+    std::lock_guard lock(_sinkMutex);
+
+    sink->setFilter(filterMode, levelMask);
+    updateEnabledLevels();
+}
+
+logger::sink::Lag Logger::getSinkLag(const std::shared_ptr<logger::Sink>& sink)
+{
+    std::lock_guard lock(_sinkMutex);
+
+    for (const auto& entry : _sinkRegistry.current().entries) {
+        if (entry.sink == sink && entry.worker) {
+            return entry.worker->getLag();
+        }
+    }
+    return {};
+}
+
+bool Logger::removeSink(const std::shared_ptr<logger::Sink>& sink)
+{
+    // the worker would wait for itself to leave the sinks, and nobody would
+    // get _sinkMutex in the meantime.
+    if (std::this_thread::get_id() == _worker.get_id()) {
+        return false;
+    }
+
+    std::lock_guard lock(_sinkMutex);
+    logger::SinkRegistry::Snapshot sinks = _sinkRegistry.current();
+    const auto it = std::ranges::find(sinks.entries, sink, &logger::SinkRegistry::Entry::sink);
+
+    // a sink thread can't stop itself either.
+    if (it == sinks.entries.end() || (it->worker && it->worker->isCurrentThread())) {
+        return false;
+    }
+
+    const std::shared_ptr<logger::SinkWorker> worker = std::move(it->worker);
+
+    sinks.entries.erase(it);
+    _sinkRegistry.publish(std::move(sinks));
+    // past this point, the worker can't be writing to the sink anymore.
+    _sinkRegistry.waitForReader();
+
+    if (worker) {
+        worker->stop();
+    }
+    sink->flush();
+    sink->close();
+
+    if (std::dynamic_pointer_cast<logger::ConsoleSink>(sink)) {
+        _hasConsoleSink = false;
+    }
+    updateEnabledLevels();
+    return true;
+}
+
+void Logger::attachSink(const std::shared_ptr<logger::Sink>& sink)
+{
+    logger::SinkRegistry::Snapshot sinks = _sinkRegistry.current();
+    logger::SinkRegistry::Entry& entry = sinks.entries.emplace_back(sink);
+
+    if (_isInitialized && _settings.isThreadPerSink()) {
+        entry.worker = std::make_shared<logger::SinkWorker>(sink);
+    }
+    _sinkRegistry.publish(std::move(sinks));
+    updateEnabledLevels();
+}
+
+void Logger::updateEnabledLevels()
+{
+    const auto& entries = _sinkRegistry.current().entries;
+
+    if (entries.empty()) {
+        _enabledLevels.store(0xFFFF, std::memory_order_relaxed);
         return;
     }
 
-    _queue.push(Log{ std::string(message), level, loc });
+    uint16_t enabledLevels = 0;
+
+    for (const auto& entry : entries) {
+        enabledLevels |= entry.sink->getAcceptedLevels();
+    }
+    _enabledLevels.store(enabledLevels, std::memory_order_relaxed);
 }
 
 void Logger::workerLoop()
 {
+    // names the thread in the logs the worker emits itself (drop reports).
+    logger::setThreadLabel("LoggerWorker");
+
+    auto& threads = logger::ThreadRegistry::getInstance();
     std::vector<Log> batch;
     batch.reserve(_settings.getMaxBatchSize());
 
     while (_isRunning) {
         // wait for new logs or timeout
         _queue.waitForData(milliseconds(_settings.getFlushIntervalMs()), _isRunning);
+        // threads retired from now on may still have logs in the queue.
+        const uint64_t epoch = threads.advanceEpoch();
         // fetch logs into batch
-        collectBatch(batch);
+        const bool isDrained = collectBatch(batch);
+        reportDrops(batch, false);
+        recalibrateClock();
         // flush if there are logs
         if (!batch.empty()) {
             flushBatch(batch);
         }
+        reclaimThreads(epoch, isDrained);
     }
+    _queue.close();
     collectRemainingLogs(batch);
+    reportDrops(batch, true);
     if (!batch.empty()) {
         flushBatch(batch);
     }
 }
 
-void Logger::collectBatch(std::vector<Log>& batch)
+bool Logger::collectBatch(std::vector<Log>& batch)
 {
     while (batch.size() < _settings.getMaxBatchSize()) {
         std::optional<Log> log = _queue.pop();
 
         if (!log) {
-            break;
+            return true;
         }
         batch.emplace_back(std::move(*log));
     }
+    return false;
 }
 
 void Logger::collectRemainingLogs(std::vector<Log>& batch)
@@ -118,30 +361,126 @@ void Logger::collectRemainingLogs(std::vector<Log>& batch)
 
 void Logger::flushBatch(std::vector<Log>& batch)
 {
-    std::vector<std::shared_ptr<logger::Sink>> sinksCopy;
+    // one atomic load: sinks can be added or removed meanwhile without
+    // blocking the worker, the snapshot stays valid until the reader is gone.
+    const logger::SinkRegistry::Reader sinks(_sinkRegistry);
+    uint16_t batchLevels = 0;
 
-    // copying sinks references for outside writing safety
-    {
-        std::lock_guard lock(_sinkMutex);
-        sinksCopy = _sinks;
+    for (Log& log : batch) {
+        log.resolveMessage(&_arena);
+        batchLevels |= static_cast<uint16_t>(log.getLevel());
     }
 
-    std::unordered_set<logger::Sink*> sinksToFlush;
+    if (_settings.isThreadPerSink()) {
+        dispatchBatch(batch, *sinks);
+        return;
+    }
 
-    for (Log& log : batch) {
-        for (const auto& sink : _sinks) {
-            if (sink->shouldLog(log.getLevel())) {
-                sink->write(log);
-                sinksToFlush.insert(sink.get());
-            }
+    // sinks sharing a format (and settings) share its rendering too.
+    _renderCache.reset(batch);
+    for (const auto& entry : sinks->entries) {
+        // sinks that accept none of the batch's levels are neither written nor flushed.
+        if ((entry.sink->getAcceptedLevels() & batchLevels) != 0) {
+            entry.sink->writeRendered(batch, _renderCache);
+            entry.sink->flush();
         }
     }
-    for (const auto& sink : sinksCopy) {
-        if (sinksToFlush.contains(sink.get())) {
-            sink->flush();
+    // destroying the logs releases their arena memory, which recycles every
+    // slab they were the last users of.
+    batch.clear();
+}
+
+void Logger::dispatchBatch(
+    std::vector<Log>& batch,
+    const logger::SinkRegistry::Snapshot& sinks
+)
+{
+    // the batch is shared by every sink thread, and released by the last one.
+    const auto shared = std::make_shared<const std::vector<Log>>(std::move(batch));
+
+    batch = std::vector<Log>();
+    batch.reserve(_settings.getMaxBatchSize());
+
+    for (const auto& [sink, worker] : sinks.entries) {
+        if (!worker) {
+            continue;
+        }
+
+        const uint16_t acceptedLevels = sink->getAcceptedLevels();
+        const auto count = static_cast<std::size_t>(std::ranges::count_if(*shared, [&](const Log& log) {
+            return (acceptedLevels & static_cast<uint16_t>(log.getLevel())) != 0;
+        }));
+
+        if (count != 0) {
+            worker->push(shared, count);
         }
     }
-    batch.clear();
+}
+
+void Logger::reclaimThreads(const uint64_t epoch, const bool isDrained)
+{
+    if (!isDrained) {
+        return;
+    }
+
+    // sink threads may still be writing batches dispatched earlier.
+    const logger::SinkRegistry::Reader sinks(_sinkRegistry);
+
+    for (const auto& entry : sinks->entries) {
+        if (entry.worker && entry.worker->getLag().pendingLogs != 0) {
+            return;
+        }
+    }
+    logger::ThreadRegistry::getInstance().reclaim(epoch);
+}
+
+void Logger::recalibrateClock()
+{
+    const auto now = steady_clock::now();
+
+    if (now - _lastCalibration < CLOCK_CALIBRATION_INTERVAL) {
+        return;
+    }
+    _lastCalibration = now;
+    logger::clock::calibrate();
+}
+
+void Logger::reportDrops(std::vector<Log>& batch, const bool force)
+{
+    const auto now = steady_clock::now();
+
+    if (!force && now - _lastDropReport < milliseconds(_settings.getDropReportIntervalMs())) {
+        return;
+    }
+    _lastDropReport = now;
+
+    std::string details;
+    uint64_t total = 0;
+
+    for (std::size_t k = 0; k < logger::level::kCount; ++k) {
+        const auto level = static_cast<logger::Level>(1 << k);
+        const uint64_t dropped = _queue.getDroppedCount(level);
+        const uint64_t count = dropped - _reportedDrops[k];
+
+        if (count == 0) {
+            continue;
+        }
+        _reportedDrops[k] = dropped;
+        total += count;
+        std::format_to(
+            std::back_inserter(details),
+            "{}{}: {}",
+            details.empty() ? "" : ", ", logger::level::to_string(level), count
+        );
+    }
+
+    if (total != 0) {
+        batch.emplace_back(
+            std::format("{} messages dropped because the queue was full ({}).", total, details),
+            SHUVLOG_CALLSITE(logger::Level::kWarning),
+            &_arena
+        );
+    }
 }
 
 std::string Logger::generateLogFileName(
@@ -162,15 +501,38 @@ void Logger::shutdown()
     if (!_isInitialized) {
         return;
     }
-    LOG_INFO("Shutting down Logger, will dump remaining logs ({}).", _queue.size());
+    // what call sites dropped since their last log would never be told otherwise.
+    _callsites.drain([this](
+        const logger::Callsite& site,
+        const uint64_t suppressed,
+        const uint64_t repeated
+    ) {
+        if (repeated != 0) {
+            submit(site, std::format("Last message repeated {} times.", repeated));
+        }
+        if (suppressed != 0) {
+            submit(site, std::format("{} logs suppressed by the rate limit of this call site.", suppressed));
+        }
+    });
+    log(SHUVLOG_CALLSITE(logger::Level::kInfo), "Shutting down Logger, will dump remaining logs ({}).", _queue.size());
     _isRunning = false;
     _queue.notifyAll();
     if (_worker.joinable()) {
         _worker.join();
     }
-    for (const auto& sink : _sinks) {
-        sink->close();
+
+    std::lock_guard lock(_sinkMutex);
+    logger::SinkRegistry::Snapshot sinks = _sinkRegistry.current();
+
+    // sink threads write what they still have queued before the sinks are closed.
+    for (auto& entry : sinks.entries) {
+        if (entry.worker) {
+            entry.worker->stop();
+            entry.worker.reset();
+        }
+        entry.sink->close();
     }
+    _sinkRegistry.publish(std::move(sinks));
     _isInitialized = false;
 }
 
@@ -0,0 +1,96 @@
+#include "logger/JsonEncoder.h"
+#include "logger/RenderCache.h"
+#include "logger/TextEncoder.h"
+
+namespace logger
+{
+
+std::string_view RenderedBatch::select(const uint16_t levels, std::string& scratch) const
+{
+    // every log of the batch is kept: no need to copy anything.
+    if ((_batchLevels & ~levels) == 0) {
+        return _text;
+    }
+
+    scratch.clear();
+    for (std::size_t k = 0; k < _logs.size(); ++k) {
+        if ((levels & static_cast<uint16_t>(_logs[k].getLevel())) != 0) {
+            scratch += get(k);
+        }
+    }
+    return scratch;
+}
+
+void RenderCache::reset(const std::span<const Log> logs)
+{
+    _logs = logs;
+    _used = 0;
+    _batchLevels = 0;
+    for (const Log& log : logs) {
+        _batchLevels |= static_cast<uint16_t>(log.getLevel());
+    }
+}
+
+const RenderedBatch& RenderCache::get(
+    const RenderFormat format,
+    const sink::Settings& settings,
+    const uint16_t acceptedLevels
+)
+{
+    // JSON always writes every field.
+    const sink::Settings key = format == RenderFormat::kJson ? sink::Settings() : settings;
+    const uint16_t levels = acceptedLevels & _batchLevels;
+
+    for (std::size_t k = 0; k < _used; ++k) {
+        RenderedBatch& rendered = _rendered[k];
+
+        if (rendered._format != format || rendered._settings != key) {
+            continue;
+        }
+        // rendered for sinks that filter more, rendering again for everyone.
+        if ((levels & ~rendered._renderedLevels) != 0) {
+            render(rendered, rendered._renderedLevels | levels);
+        }
+        return rendered;
+    }
+
+    if (_used == _rendered.size()) {
+        _rendered.emplace_back();
+    }
+
+    RenderedBatch& rendered = _rendered[_used++];
+
+    // sinks are usually the same from a batch to the next: keeping the
+    // call sites rendered for the same format.
+    if (rendered._format != format || rendered._settings != key) {
+        rendered._sources.clear();
+    }
+    rendered._format = format;
+    rendered._settings = key;
+    rendered._logs = _logs;
+    rendered._batchLevels = _batchLevels;
+    render(rendered, levels);
+    return rendered;
+}
+
+void RenderCache::render(RenderedBatch& rendered, const uint16_t levels)
+{
+    rendered._renderedLevels = levels;
+    rendered._text.clear();
+    rendered._ends.clear();
+    rendered._ends.reserve(rendered._logs.size());
+
+    for (const Log& log : rendered._logs) {
+        if ((levels & static_cast<uint16_t>(log.getLevel())) != 0) {
+            if (rendered._format == RenderFormat::kJson) {
+                json::appendLog(rendered._text, log, rendered._timestampRenderer, rendered._sources);
+                rendered._text += '\n';
+            } else {
+                text::appendLog(rendered._text, log, rendered._settings, rendered._timestampRenderer, rendered._sources);
+            }
+        }
+        rendered._ends.push_back(static_cast<uint32_t>(rendered._text.size()));
+    }
+}
+
+}
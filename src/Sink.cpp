@@ -4,6 +4,17 @@
 namespace logger
 {
 
+std::string sink::toCommand(const int argc, const char* argv[])
+{
+    std::string command;
+
+    for (int i = 0; i < argc; i++) {
+        command += argv[i];
+        command += (i + 1 == argc ? "" : " ");
+    }
+    return command;
+}
+
 Sink::Sink(sink::Settings settings)
     : _settings(settings)
     , _filterMode(sink::FilterMode::kAll)
@@ -20,6 +31,11 @@ Sink::Sink(
     , _filterMode(filterMode)
     , _minimumLevel(Level::kDebug)
     , _levelMask(0xFFFF)
+{
+    setFilter(filterMode, levelMask);
+}
+
+void Sink::setFilter(sink::FilterMode filterMode, uint16_t levelMask)
 {
     switch (filterMode)
     {
@@ -28,36 +44,53 @@ Sink::Sink(
                 throw exception::InvalidLevel();
             }
 
+            _filterMode = filterMode;
             _minimumLevel = static_cast<Level>(levelMask);
+            _levelMask = 0xFFFF;
+            // every bit at or above the minimum level
+            _acceptedLevels.store(static_cast<uint16_t>(~(levelMask - 1)), std::memory_order_relaxed);
             break;
         }
 
         case sink::FilterMode::kExplicit: {
+            _filterMode = filterMode;
+            _minimumLevel = Level::kDebug;
             _levelMask = levelMask;
+            _acceptedLevels.store(levelMask, std::memory_order_relaxed);
             break;
         }
 
         case sink::FilterMode::kAll: {
+            _filterMode = filterMode;
+            _minimumLevel = Level::kDebug;
+            _levelMask = 0xFFFF;
+            _acceptedLevels.store(0xFFFF, std::memory_order_relaxed);
             break;
         }
     }
 }
 
-bool Sink::shouldLog(Level level) const
+void Sink::writeBatch(const std::span<const Log> logs)
 {
-    switch (_filterMode)
-    {
-        case sink::FilterMode::kAll:
-            return true;
-
-        case sink::FilterMode::kMinimumLevel:
-            return static_cast<uint16_t>(level) >=
-                   static_cast<uint16_t>(_minimumLevel);
+    for (const Log& log : logs) {
+        if (shouldLog(log.getLevel())) {
+            write(log);
+        }
+    }
+}
 
-        case sink::FilterMode::kExplicit:
-            return (static_cast<uint16_t>(level) & _levelMask) != 0;
+std::vector<Level> Sink::getDisplayedLevels() const
+{
+    switch (_filterMode) {
+        case sink::FilterMode::kMinimumLevel:   return { _minimumLevel };
+        case sink::FilterMode::kExplicit:       return level::getIndividualLevelsFromMask(_levelMask);
+        default:                                return {};
     }
-    return false;
+}
+
+void Sink::writeRendered(const std::span<const Log> logs, RenderCache& /*cache*/)
+{
+    writeBatch(logs);
 }
 
 bool Sink::isSingleLevel(uint16_t value)
@@ -0,0 +1,81 @@
+#include <thread>
+
+#include "logger/SinkRegistry.h"
+
+namespace logger
+{
+
+SinkRegistry::Reader::Reader(SinkRegistry& registry)
+    : _registry(registry)
+    , _snapshot(registry._snapshot.load(std::memory_order_acquire))
+{
+    // announcing the snapshot, then checking it's still the current one: if
+    // it is, no writer can have missed the announcement before freeing it.
+    for (;;) {
+        _registry._hazard.store(_snapshot, std::memory_order_seq_cst);
+
+        const Snapshot* current = _registry._snapshot.load(std::memory_order_seq_cst);
+
+        if (current == _snapshot) {
+            break;
+        }
+        _snapshot = current;
+    }
+}
+
+SinkRegistry::Reader::~Reader()
+{
+    _registry._hazard.store(nullptr, std::memory_order_release);
+}
+
+SinkRegistry::SinkRegistry()
+    : _snapshot(new Snapshot())
+{}
+
+SinkRegistry::~SinkRegistry()
+{
+    for (const Snapshot* snapshot : _retired) {
+        delete snapshot;
+    }
+    delete _snapshot.load(std::memory_order_relaxed);
+}
+
+const SinkRegistry::Snapshot& SinkRegistry::current() const
+{
+    return *_snapshot.load(std::memory_order_relaxed);
+}
+
+void SinkRegistry::publish(Snapshot snapshot)
+{
+    const std::size_t size = snapshot.entries.size();
+    const Snapshot* previous = _snapshot.exchange(new Snapshot(std::move(snapshot)), std::memory_order_seq_cst);
+
+    _size.store(size, std::memory_order_relaxed);
+    _retired.push_back(previous);
+    reclaim();
+}
+
+void SinkRegistry::waitForReader()
+{
+    while (!_retired.empty()) {
+        reclaim();
+        if (!_retired.empty()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SinkRegistry::reclaim()
+{
+    const Snapshot* inUse = _hazard.load(std::memory_order_seq_cst);
+
+    std::erase_if(_retired, [inUse](const Snapshot* snapshot) {
+        if (snapshot == inUse) {
+            return false;
+        }
+        delete snapshot;
+        return true;
+    });
+}
+
+}
@@ -0,0 +1,115 @@
+#include <chrono>
+
+#include "logger/SinkWorker.h"
+#include "logger/Thread.h"
+
+namespace logger
+{
+
+SinkWorker::SinkWorker(std::shared_ptr<Sink> sink)
+    : _sink(std::move(sink))
+    , _settings(_sink->getThreadSettings())
+    , _queue(_settings.queueCapacity < 1 ? 1 : _settings.queueCapacity)
+    , _thread(&SinkWorker::run, this)
+{}
+
+SinkWorker::~SinkWorker()
+{
+    stop();
+}
+
+void SinkWorker::push(Batch batch, const std::size_t count)
+{
+    {
+        std::lock_guard lock(_mutex);
+
+        if (_isStopping || _size == _queue.size()) {
+            _droppedLogs.fetch_add(count, std::memory_order_relaxed);
+            return;
+        }
+        _queue[(_head + _size) % _queue.size()] = { std::move(batch), count };
+        ++_size;
+        _pendingLogs.fetch_add(count, std::memory_order_relaxed);
+    } // nested scope so that mutex is released without waiting to notify.
+    _cvar.notify_one();
+}
+
+void SinkWorker::stop()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _isStopping = true;
+    }
+    _cvar.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+sink::Lag SinkWorker::getLag() const
+{
+    std::size_t pendingBatches;
+
+    {
+        std::lock_guard lock(_mutex);
+        pendingBatches = _size;
+    }
+    return {
+        _pendingLogs.load(std::memory_order_relaxed),
+        pendingBatches,
+        _droppedLogs.load(std::memory_order_relaxed),
+    };
+}
+
+void SinkWorker::run()
+{
+    using namespace std::chrono;
+
+    setThreadLabel("SinkWorker");
+
+    const auto flushInterval = milliseconds(_settings.flushIntervalMs);
+    auto lastFlush = steady_clock::now();
+    std::size_t unflushed = 0;
+
+    for (;;) {
+        QueuedBatch queued;
+
+        {
+            std::unique_lock lock(_mutex);
+
+            _cvar.wait_for(lock, flushInterval, [&] {
+                return _size != 0 || _isStopping;
+            });
+            if (_size != 0) {
+                queued = std::move(_queue[_head]);
+                _head = (_head + 1) % _queue.size();
+                --_size;
+            } else if (_isStopping) {
+                break;
+            }
+        }
+
+        if (queued.batch) {
+            _renderCache.reset(*queued.batch);
+            _sink->writeRendered(*queued.batch, _renderCache);
+            unflushed += queued.count;
+            _pendingLogs.fetch_sub(queued.count, std::memory_order_relaxed);
+            // the batch is released here if the other sinks are done with it.
+            queued.batch.reset();
+        }
+
+        const auto now = steady_clock::now();
+
+        if (unflushed != 0 && (unflushed >= _settings.maxBatchSize || now - lastFlush >= flushInterval)) {
+            _sink->flush();
+            unflushed = 0;
+            lastFlush = now;
+        }
+    }
+
+    if (unflushed != 0) {
+        _sink->flush();
+    }
+}
+
+}
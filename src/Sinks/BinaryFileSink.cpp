@@ -0,0 +1,241 @@
+#include <functional>
+
+#include "logger/Logger.h"
+#include "logger/OsInfo.h"
+#include "logger/Timestamp.h"
+#include "logger/Exceptions/CouldNotOpenFile.h"
+#include "logger/Sinks/BinaryFileSink.h"
+
+namespace logger
+{
+
+static const char* EXTENSION_NAME = "Binary";
+
+BinaryFileSink::BinaryFileSink(
+    const std::string &filepath,
+    sink::Settings settings
+)
+    : BinaryFileSink(
+        filepath,
+        sink::FilterMode::kAll,
+        0xFFFF,
+        settings
+    )
+{}
+
+BinaryFileSink::BinaryFileSink(
+    const std::string &filepath,
+    sink::FilterMode filterMode,
+    uint16_t levelMask,
+    sink::Settings settings
+)
+    : FileSink(
+        filepath,
+        EXTENSION_NAME,
+        std::string(binary::kExtension),
+        filterMode,
+        levelMask,
+        settings
+    )
+{
+    // reopened in binary mode, so that nothing gets translated on the way.
+    _openMode = std::ios::out | std::ios::trunc | std::ios::binary;
+    _file.close();
+    _file.open(_absoluteFilepath, _openMode);
+    if (!_file.is_open()) {
+        throw exception::CouldNotOpenFile(filepath);
+    }
+
+    _buffer += binary::kMagic;
+    _buffer += static_cast<char>(binary::kVersion);
+    // formatting is the decoder's job: it needs to know how.
+    _record.clear();
+    binary::appendVarint(_record, binary::toFlags(_settings));
+    appendRecord(binary::Record::kSettings);
+    writeFileHeader(_buffer);
+}
+
+void BinaryFileSink::write(const Log& log)
+{
+    writeBatch(std::span(&log, 1));
+}
+
+void BinaryFileSink::writeBatch(const std::span<const Log> logs)
+{
+    const uint16_t acceptedLevels = getAcceptedLevels();
+    bool isSynced = false;
+
+    // before encoding anything: a new file starts with new definitions.
+    rotateIfNeeded();
+    _buffer.clear();
+    for (const Log& log : logs) {
+        if ((acceptedLevels & static_cast<uint16_t>(log.getLevel())) == 0) {
+            continue;
+        }
+        if (!isSynced) {
+            appendSync(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                log.getTimestamp().time_since_epoch()
+            ).count());
+            isSynced = true;
+        }
+        appendLog(log);
+    }
+    writeToFile(_buffer);
+}
+
+void BinaryFileSink::appendSync(const int64_t timestamp)
+{
+    _record.clear();
+    binary::appendVarint(_record, static_cast<uint64_t>(timestamp));
+    appendRecord(binary::Record::kSync);
+    _lastTimestamp = timestamp;
+}
+
+void BinaryFileSink::appendLog(const Log& log)
+{
+    const uint64_t threadId = getThreadId(log);
+    const uint64_t callsiteId = getCallsiteId(log);
+    const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        log.getTimestamp().time_since_epoch()
+    ).count();
+    const uint64_t delta = binary::zigzag(timestamp - _lastTimestamp);
+    const std::string_view message = log.getMessage();
+    const uint32_t sampleRate = log.getSampleRate();
+    const bool isSampled = sampleRate > 1;
+    const std::size_t size =
+        binary::varintSize(delta)
+        + 1
+        + binary::varintSize(threadId)
+        + binary::varintSize(callsiteId)
+        + (isSampled ? binary::varintSize(sampleRate) : 0)
+        + message.size();
+
+    // written in place: the message is only copied once, into the buffer.
+    _buffer += static_cast<char>(isSampled ? binary::Record::kSampledLog : binary::Record::kLog);
+    binary::appendVarint(_buffer, size);
+    binary::appendVarint(_buffer, delta);
+    _buffer += static_cast<char>(level::toIndex(log.getLevel()));
+    binary::appendVarint(_buffer, threadId);
+    binary::appendVarint(_buffer, callsiteId);
+    if (isSampled) {
+        binary::appendVarint(_buffer, sampleRate);
+    }
+    _buffer += message;
+    _lastTimestamp = timestamp;
+}
+
+uint64_t BinaryFileSink::getThreadId(const Log& log)
+{
+    const ThreadInfo& thread = log.getThreadInfo();
+
+    if (thread.index >= _threads.size()) {
+        _threads.resize(thread.index + 1);
+    }
+
+    KnownThread& known = _threads[thread.index];
+
+    // a relabeled thread comes with a new snapshot, hence a new definition.
+    if (known.version != thread.version) {
+        known = { thread.version, _threadCount++ };
+        _record.clear();
+        binary::appendVarint(_record, known.id);
+        binary::appendString(_record, thread.label);
+        binary::appendString(_record, thread.prettyId);
+        appendRecord(binary::Record::kThread);
+    }
+    return known.id;
+}
+
+uint64_t BinaryFileSink::getCallsiteId(const Log& log)
+{
+    const Callsite& site = log.getCallsite();
+    const auto [it, isNew] = _callsites.try_emplace(&site, _callsites.size());
+
+    if (isNew) {
+        _record.clear();
+        binary::appendVarint(_record, it->second);
+        binary::appendVarint(_record, site.line);
+        binary::appendVarint(_record, site.column);
+        binary::appendString(_record, site.file);
+        binary::appendString(_record, site.function);
+        appendRecord(binary::Record::kCallsite);
+    }
+    return it->second;
+}
+
+void BinaryFileSink::appendRecord(const binary::Record record)
+{
+    _buffer += static_cast<char>(record);
+    binary::appendVarint(_buffer, _record.size());
+    _buffer += _record;
+}
+
+void BinaryFileSink::writeHeader(
+    const std::string& projectName,
+    const int argc,
+    const char* argv[],
+    const BuildInfo& buildInfo,
+    const Settings& /*settings*/
+)
+{
+    const std::string command = sink::toCommand(argc, argv);
+    std::string displayedLevelMask;
+
+    if (_filterMode == sink::FilterMode::kMinimumLevel) {
+        displayedLevelMask = level::to_string(_minimumLevel);
+    } else if (_filterMode == sink::FilterMode::kExplicit) {
+        for (const auto& level : level::getIndividualLevelsFromMask(_levelMask)) {
+            displayedLevelMask += level::to_string(level);
+            displayedLevelMask += ", ";
+        }
+        displayedLevelMask.resize(displayedLevelMask.size() - 2);
+    }
+
+    // same keys as the NDJSON header, so that the decoder can render both formats.
+    const std::pair<std::string_view, std::string> infos[] = {
+        { "projectName",        projectName                             },
+        { "version",            buildInfo.getVersion()                  },
+        { "buildType",          buildInfo.getType()                     },
+        { "filterMode",         sink::filter::to_string(_filterMode)    },
+        { "levelMask",          displayedLevelMask                      },
+        { "command",            command                                 },
+        { "startTime",          formatTimestamp(system_clock::now())    },
+        { "osName",             osname()                                },
+        { "kernelVersion",      kernelver()                             },
+        { "compiler",           buildInfo.getCompiler()                 },
+        { "compilationFlags",   buildInfo.getCompilerFlags()            },
+        { "buildSystem",        buildInfo.getBuildSystem()              },
+    };
+
+    _record.clear();
+    binary::appendVarint(_record, std::size(infos));
+    for (const auto& [key, value] : infos) {
+        binary::appendString(_record, key);
+        binary::appendString(_record, value);
+    }
+
+    _buffer.clear();
+    appendRecord(binary::Record::kHeader);
+    writeFileHeader(_buffer);
+}
+
+void BinaryFileSink::flush()
+{
+    _file.flush();
+}
+
+void BinaryFileSink::onFileRotated()
+{
+    _threads.clear();
+    _threadCount = 0;
+    _callsites.clear();
+}
+
+void BinaryFileSink::close()
+{
+    if (_file.is_open()) {
+        _file.close();
+    }
+}
+
+}
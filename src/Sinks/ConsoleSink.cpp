@@ -5,8 +5,6 @@
 
 #include "logger/Sinks/ConsoleSink.h"
 #include "logger/Logger.h"
-#include "logger/Timestamp.h"
-#include "logger/Thread.h"
 
 namespace logger
 {
@@ -29,90 +27,69 @@ ConsoleSink::ConsoleSink(
     , _useColors(useColors)
 {}
 
-static std::string formatLog(
-    const Log& log,
-    const sink::Settings& settings
-)
+/**
+ * @return  The stream a log of the given level is printed to.
+ */
+static std::ostream& getStream(const Level level)
 {
-    std::string output;
-    output.reserve(192); // avoids the first necessary dynamic allocations, to save some cpu cycles
-
-    if (settings.showTimestamp) {
-        std::format_to(std::back_inserter(output),
-            "{} ",
-            formatTimestamp(
-                log.getTimestamp(),
-                settings.showOnlyTime,
-                settings.showMilliseconds
-            )
-        );
-    }
+    return static_cast<uint16_t>(level) >= static_cast<uint16_t>(Level::kError)
+        ? std::cerr
+        : std::cout;
+}
 
-    if (settings.showThreadInfo) {
-        if (settings.showThreadId) {
-            std::format_to(std::back_inserter(output),
-                "[{} ({})] ",
-                log.getThreadName(),
-                getPrettyThreadId(log.getThreadId())
-            );
-        } else {
-            std::format_to(std::back_inserter(output),
-                "[{}] ",
-                log.getThreadName()
-            );
-        }
+void ConsoleSink::appendLog(const Log& log, const std::string_view line)
+{
+    if (_useColors) {
+        _buffer += level::getColor(log.getLevel());
     }
 
-    std::format_to(std::back_inserter(output),
-        "{:>8}: ",
-        level::to_string(log.getLevel())
-    );
+    _buffer += line;
 
-    output += log.getMessage();
-
-    if (settings.showSource) {
-        const auto& loc = log.getLocation();
-
-        output += " (";
-        output += loc.file_name();
-
-        if (settings.showLineNumber) {
-            std::format_to(std::back_inserter(output),
-                ":{}",
-                loc.line()
-            );
-        }
-        if (settings.showColumnNumber) {
-            std::format_to(std::back_inserter(output),
-                ":{}",
-                loc.column()
-            );
-        }
-        output += ")";
+    if (_useColors) {
+        _buffer += SHUVLOG_RST;
     }
+}
 
-    output += "\n";
+void ConsoleSink::write(const Log& log)
+{
+    writeBatch(std::span(&log, 1));
+}
 
-    return output;
+void ConsoleSink::writeBatch(const std::span<const Log> logs)
+{
+    _renderCache.reset(logs);
+    writeRendered(logs, _renderCache);
 }
 
-void ConsoleSink::write(const Log& log)
+void ConsoleSink::writeRendered(const std::span<const Log> logs, RenderCache& cache)
 {
-    std::ostream& out =
-        static_cast<uint8_t>(log.getLevel()) >= static_cast<uint8_t>(Level::kError)
-            ? std::cerr
-            : std::cout;
+    const uint16_t acceptedLevels = getAcceptedLevels();
+    const RenderedBatch& rendered = cache.get(RenderFormat::kText, _settings, acceptedLevels);
+    std::ostream* current = nullptr;
 
-    const std::string output = formatLog(log, _settings);
+    _buffer.clear();
+    for (std::size_t k = 0; k < logs.size(); ++k) {
+        const Log& log = logs[k];
 
-    if (_useColors) {
-        out << level::getColor(log.getLevel());
-    }
+        if ((acceptedLevels & static_cast<uint16_t>(log.getLevel())) == 0) {
+            continue;
+        }
 
-    out << output;
+        std::ostream& out = getStream(log.getLevel());
 
-    if (_useColors) {
-        out << SHUVLOG_RST;
+        // switching streams: what has been buffered so far goes first, to
+        // keep lines in order.
+        if (&out != current) {
+            if (current) {
+                current->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+            }
+            _buffer.clear();
+            current = &out;
+        }
+        appendLog(log, rendered.get(k));
+    }
+    if (current) {
+        current->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
     }
 }
 
@@ -1,7 +1,5 @@
+#include "logger/JsonEncoder.h"
 #include "logger/Logger.h"
-#include "logger/OsInfo.h"
-#include "logger/Thread.h"
-#include "logger/Timestamp.h"
 #include "logger/Sinks/JsonFileSink.h"
 
 namespace logger
@@ -38,34 +36,48 @@ JsonFileSink::JsonFileSink(
     )
 {}
 
-static std::string formatLog(const Log& log)
+void JsonFileSink::write(const Log& log)
 {
-    std::ostringstream oss;
-
-    oss << "{";
-    oss << R"("timestamp":")" << formatTimestamp(log.getTimestamp()) << "\",";
-    oss << R"("level":")" << level::to_string(log.getLevel()) << "\",";
-    oss << R"("thread":{"name":")" << log.getThreadName() << R"(","id":")" << getPrettyThreadId(log.getThreadId()) << "\"},";
-    oss << R"("source":")" << log.getLocation().file_name() << "\",";
-    oss << R"("functionName":")" << log.getLocation().function_name() << "\",";
-    oss << R"("line":)" << log.getLocation().line() << ",";
-    oss << R"("column":)" << log.getLocation().column() << ",";
-    oss << R"("message":")" << log.getMessage() << "\"";
-    oss << "}";
-    return oss.str();
+    writeBatch(std::span(&log, 1));
 }
 
-void JsonFileSink::write(const Log& log)
+void JsonFileSink::writeBatch(const std::span<const Log> logs)
 {
-    char c;
+    _renderCache.reset(logs);
+    writeRendered(logs, _renderCache);
+}
 
-    _file.seekg(-3, std::ios::end);
-    _file.get(c);
-    _file.seekp(-2, std::ios::end);
-    if (c != '[') {
-        _file << ",";
+void JsonFileSink::writeRendered(const std::span<const Log> logs, RenderCache& cache)
+{
+    const uint16_t acceptedLevels = getAcceptedLevels();
+    const RenderedBatch& rendered = cache.get(RenderFormat::kJson, _settings, acceptedLevels);
+
+    // same entries as NDJSON, framed as array elements instead of lines.
+    _buffer.clear();
+    for (std::size_t k = 0; k < logs.size(); ++k) {
+        if ((acceptedLevels & static_cast<uint16_t>(logs[k].getLevel())) != 0) {
+            const std::string_view line = rendered.get(k);
+
+            _buffer += ',';
+            _buffer += line.substr(0, line.size() - 1);
+        }
     }
-    _file << formatLog(log) << "]}";
+    if (_buffer.empty()) {
+        return;
+    }
+    rotateIfNeeded();
+
+    // reopening the array over the footer, if it has been written since the
+    // last batch. Nothing is read back: whether the array is empty is known.
+    if (_hasFooter) {
+        seekFileBack(2);
+        _hasFooter = false;
+    }
+
+    const std::size_t offset = _hasEntries ? 0 : 1;
+
+    _hasEntries = true;
+    writeToFile(std::string_view(_buffer).substr(offset));
 }
 
 void JsonFileSink::writeHeader(
@@ -76,59 +88,41 @@ void JsonFileSink::writeHeader(
     const Settings& /*settings*/
 )
 {
-    std::ostringstream body;
-
-    body << "{";
-    body << R"("projectName":")" << projectName << "\",";
-    body << R"("version":")" << buildInfo.getVersion() << "\",";
-    body << R"("buildType":")" << buildInfo.getType() << "\",";
-
-    body << R"("filterMode":")" << sink::filter::to_string(_filterMode) << "\",";
-    body << R"("levelMask":)";
-
-    if (_filterMode == sink::FilterMode::kMinimumLevel) {
-        body << "\"" << level::to_string(_minimumLevel) << "\"";
-    } else if (_filterMode == sink::FilterMode::kExplicit) {
-        body << "[";
-        for (const auto& level : level::getIndividualLevelsFromMask(_levelMask)) {
-            body << "\"" << level::to_string(level) << "\",";
-        }
-        body.seekp(-1, std::ios::end);
-        body << "]";
-    } else {
-        body << R"("")";
-    }
+    std::string header = "{";
 
-    body << ",";
+    json::appendHeaderFields(header, projectName, argc, argv, buildInfo, _filterMode, getDisplayedLevels());
+    header += R"(,"logs":[]})";
+    writeFileHeader(header);
+    _hasFooter = true;
+}
 
-    body << R"("command":")";
-    for (int i = 0; i < argc; i++) {
-        body << argv[i] << (i + 1 == argc ? "" : " ");
+void JsonFileSink::flush()
+{
+    // the document is closed on each flush, so that it is valid whenever it
+    // is at rest on disk.
+    if (!_hasFooter) {
+        writeToFile("]}");
+        _hasFooter = true;
     }
-    body << "\",";
-    body << R"("startTime":")" << formatTimestamp(system_clock::now()) << "\",";
-
-    body << R"("osName":")" << osname() << "\",";
-    body << R"("kernelVersion":")" << kernelver() << "\",";
-    body << R"("compiler":")" << buildInfo.getCompiler() << "\",";
-    body << R"("compilationFlags":")" << buildInfo.getCompilerFlags() << "\",";
-    body << R"("buildSystem":")" << buildInfo.getBuildSystem() << "\",";
-
-    body << R"("logs":[])";
-
-    body << "}";
+    _file.flush();
+}
 
-    _file << body.str();
+void JsonFileSink::onFileClosing()
+{
+    flush();
 }
 
-void JsonFileSink::flush()
+void JsonFileSink::onFileRotated()
 {
-    _file.flush();
+    // the header written again ends with an empty, closed, array.
+    _hasEntries = false;
+    _hasFooter = true;
 }
 
 void JsonFileSink::close()
 {
     if (_file.is_open()) {
+        flush();
         _file.close();
     }
 }
@@ -40,76 +40,25 @@ LogFileSink::LogFileSink(
     )
 {}
 
-static std::string formatLog(
-    const Log& log,
-    const sink::Settings& settings
-)
+void LogFileSink::write(const Log& log)
 {
-    std::string output;
-    output.reserve(192); // avoids the first necessary dynamic allocations, to save some cpu cycles
-
-    if (settings.showTimestamp) {
-        std::format_to(std::back_inserter(output),
-            "{} ",
-            formatTimestamp(
-                log.getTimestamp(),
-                settings.showOnlyTime,
-                settings.showMilliseconds
-            )
-        );
-    }
-
-    if (settings.showThreadInfo) {
-        if (settings.showThreadId) {
-            std::format_to(std::back_inserter(output),
-                "[{} ({})] ",
-                log.getThreadName(),
-                getPrettyThreadId(log.getThreadId())
-            );
-        } else {
-            std::format_to(std::back_inserter(output),
-                "[{}] ",
-                log.getThreadName()
-            );
-        }
-    }
-
-    std::format_to(std::back_inserter(output),
-        "{:>8}: ",
-        level::to_string(log.getLevel())
-    );
-
-    output += log.getMessage();
-
-    if (settings.showSource) {
-        const auto& loc = log.getLocation();
-
-        output += " (";
-        output += loc.file_name();
-
-        if (settings.showLineNumber) {
-            std::format_to(std::back_inserter(output),
-                ":{}",
-                loc.line()
-            );
-        }
-        if (settings.showColumnNumber) {
-            std::format_to(std::back_inserter(output),
-                ":{}",
-                loc.column()
-            );
-        }
-        output += ")";
-    }
-
-    output += "\n";
+    writeBatch(std::span(&log, 1));
+}
 
-    return output;
+void LogFileSink::writeBatch(const std::span<const Log> logs)
+{
+    _renderCache.reset(logs);
+    writeRendered(logs, _renderCache);
 }
 
-void LogFileSink::write(const Log& log)
+void LogFileSink::writeRendered(const std::span<const Log> /*logs*/, RenderCache& cache)
 {
-    _file << formatLog(log, _settings);
+    const uint16_t acceptedLevels = getAcceptedLevels();
+    const std::string_view lines = cache.get(RenderFormat::kText, _settings, acceptedLevels)
+        .select(acceptedLevels, _buffer);
+
+    rotateIfNeeded();
+    writeToFile(lines);
 }
 
 void LogFileSink::writeHeader(
@@ -120,11 +69,7 @@ void LogFileSink::writeHeader(
     const Settings& /*settings*/
 )
 {
-    std::ostringstream command;
-    for (int k = 0; k < argc; k++) {
-        command << argv[k];
-    }
-
+    const std::string command = sink::toCommand(argc, argv);
     std::string displayedLevelMask;
 
     if (_filterMode == sink::FilterMode::kMinimumLevel) {
@@ -149,7 +94,7 @@ void LogFileSink::writeHeader(
         { "Filter mode",        sink::filter::to_string(_filterMode)                },
         { "Level(s)",           displayedLevelMask                               },
         { "",                   ""                                                  },
-        { "Command",            command.str()                                       },
+        { "Command",            command                                             },
         { "Start time",         formatTimestamp(system_clock::now())                },
         { "",                   ""                                                  },
         { "OS",                 std::format("{} {}", osname(), kernelver())  },
@@ -179,7 +124,7 @@ void LogFileSink::writeHeader(
     }
     header << "\\*************************************************\n\n";
 
-    _file << header.str();
+    writeFileHeader(header.str());
 }
 
 void LogFileSink::flush()
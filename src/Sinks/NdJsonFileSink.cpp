@@ -1,7 +1,5 @@
+#include "logger/JsonEncoder.h"
 #include "logger/Logger.h"
-#include "logger/OsInfo.h"
-#include "logger/Thread.h"
-#include "logger/Timestamp.h"
 #include "logger/Sinks/NdJsonFileSink.h"
 
 namespace logger
@@ -38,26 +36,25 @@ NdJsonFileSink::NdJsonFileSink(
     )
 {}
 
-static std::string formatLog(const Log& log)
+void NdJsonFileSink::write(const Log& log)
 {
-    std::ostringstream oss;
+    writeBatch(std::span(&log, 1));
+}
 
-    oss << "{";
-    oss << R"("timestamp":")" << formatTimestamp(log.getTimestamp()) << "\",";
-    oss << R"("level":")" << level::to_string(log.getLevel()) << "\",";
-    oss << R"("thread":{"name":")" << log.getThreadName() << R"(","id":")" << getPrettyThreadId(log.getThreadId()) << "\"},";
-    oss << R"("source":")" << log.getLocation().file_name() << "\",";
-    oss << R"("functionName":")" << log.getLocation().function_name() << "\",";
-    oss << R"("line":)" << log.getLocation().line() << ",";
-    oss << R"("column":)" << log.getLocation().column() << ",";
-    oss << R"("message":")" << log.getMessage() << "\"";
-    oss << "}";
-    return oss.str();
+void NdJsonFileSink::writeBatch(const std::span<const Log> logs)
+{
+    _renderCache.reset(logs);
+    writeRendered(logs, _renderCache);
 }
 
-void NdJsonFileSink::write(const Log& log)
+void NdJsonFileSink::writeRendered(const std::span<const Log> /*logs*/, RenderCache& cache)
 {
-    _file << formatLog(log) << "\n";
+    const uint16_t acceptedLevels = getAcceptedLevels();
+    const std::string_view lines = cache.get(RenderFormat::kJson, _settings, acceptedLevels)
+        .select(acceptedLevels, _buffer);
+
+    rotateIfNeeded();
+    writeToFile(lines);
 }
 
 void NdJsonFileSink::writeHeader(
@@ -68,47 +65,11 @@ void NdJsonFileSink::writeHeader(
     const Settings& /*settings*/
 )
 {
-    std::ostringstream body;
-
-    body << "{";
-    body << R"("projectName":")" << projectName << "\",";
-    body << R"("version":")" << buildInfo.getVersion() << "\",";
-    body << R"("buildType":")" << buildInfo.getType() << "\",";
-
-    body << R"("filterMode":")" << sink::filter::to_string(_filterMode) << "\",";
-    body << R"("levelMask":)";
-
-    if (_filterMode == sink::FilterMode::kMinimumLevel) {
-        body << "\"" << level::to_string(_minimumLevel) << "\"";
-    } else if (_filterMode == sink::FilterMode::kExplicit) {
-        body << "[";
-        for (const auto& level : level::getIndividualLevelsFromMask(_levelMask)) {
-            body << "\"" << level::to_string(level) << "\",";
-        }
-        body.seekp(-1, std::ios::end);
-        body << "]";
-    } else {
-        body << R"("")";
-    }
-
-    body << ",";
-
-    body << R"("command":")";
-    for (int i = 0; i < argc; i++) {
-        body << argv[i] << (i + 1 == argc ? "" : " ");
-    }
-    body << "\",";
-    body << R"("startTime":")" << formatTimestamp(system_clock::now()) << "\",";
-
-    body << R"("osName":")" << osname() << "\",";
-    body << R"("kernelVersion":")" << kernelver() << "\",";
-    body << R"("compiler":")" << buildInfo.getCompiler() << "\",";
-    body << R"("compilationFlags":")" << buildInfo.getCompilerFlags() << "\",";
-    body << R"("buildSystem":")" << buildInfo.getBuildSystem() << "\"";
-
-    body << "}\n";
+    std::string header = "{";
 
-    _file << body.str();
+    json::appendHeaderFields(header, projectName, argc, argv, buildInfo, _filterMode, getDisplayedLevels());
+    header += "}\n";
+    writeFileHeader(header);
 }
 
 void NdJsonFileSink::flush()
@@ -0,0 +1,164 @@
+#include "logger/Logger.h"
+#include "logger/Sinks/RingBufferSink.h"
+
+namespace logger
+{
+
+RingBufferSink::RingBufferSink(
+    std::shared_ptr<Sink> target,
+    const std::size_t capacity,
+    const Level triggerLevel
+)
+    : RingBufferSink(
+        std::move(target),
+        capacity,
+        triggerLevel,
+        sink::FilterMode::kAll,
+        0xFFFF
+    )
+{}
+
+RingBufferSink::RingBufferSink(
+    std::shared_ptr<Sink> target,
+    const std::size_t capacity,
+    const Level triggerLevel,
+    sink::FilterMode filterMode,
+    uint16_t levelMask
+)
+    : Sink(filterMode, levelMask, sink::Settings())
+    , _target(std::move(target))
+    , _triggerLevel(static_cast<uint16_t>(triggerLevel))
+    , _records(capacity < 1 ? 1 : capacity)
+{
+    // every slot can take an inline-sized message without allocating.
+    for (Record& record : _records) {
+        record.message.reserve(Log::kInlineCapacity);
+    }
+    _dump.reserve(_records.size());
+}
+
+RingBufferSink::~RingBufferSink()
+{
+    std::lock_guard lock(_mutex);
+
+    unpinAll();
+}
+
+void RingBufferSink::write(const Log& log)
+{
+    writeBatch(std::span(&log, 1));
+}
+
+void RingBufferSink::writeBatch(const std::span<const Log> logs)
+{
+    const uint16_t acceptedLevels = getAcceptedLevels();
+    std::lock_guard lock(_mutex);
+
+    for (const Log& log : logs) {
+        const auto level = static_cast<uint16_t>(log.getLevel());
+
+        if ((acceptedLevels & level) == 0) {
+            continue;
+        }
+        record(log);
+        if (level >= _triggerLevel) {
+            dumpLocked();
+        }
+    }
+}
+
+void RingBufferSink::record(const Log& log)
+{
+    Record& record = _records[(_head + _size) % _records.size()];
+
+    auto& threads = ThreadRegistry::getInstance();
+
+    // the thread must stay registered (and identified) until the record is dumped.
+    threads.pin(log.getThreadIndex());
+    if (_size == _records.size()) {
+        threads.unpin(record.threadIndex);
+    }
+
+    record.timestamp = log.getRawTimestamp();
+    record.site = &log.getCallsite();
+    record.threadIndex = log.getThreadIndex();
+    record.sampleRate = log.getSampleRate();
+    record.message.assign(log.getMessage());
+
+    if (_size == _records.size()) {
+        _head = (_head + 1) % _records.size();
+    } else {
+        ++_size;
+    }
+}
+
+void RingBufferSink::dump()
+{
+    std::lock_guard lock(_mutex);
+
+    dumpLocked();
+}
+
+void RingBufferSink::dumpLocked()
+{
+    if (_size == 0 || !_target) {
+        return;
+    }
+
+    for (std::size_t k = 0; k < _size; ++k) {
+        const Record& record = _records[(_head + k) % _records.size()];
+
+        _dump.emplace_back(record.message, *record.site, record.timestamp, record.threadIndex, record.sampleRate);
+    }
+    _target->writeBatch(_dump);
+    _target->flush();
+    _dump.clear();
+    unpinAll();
+}
+
+void RingBufferSink::unpinAll()
+{
+    auto& threads = ThreadRegistry::getInstance();
+
+    for (std::size_t k = 0; k < _size; ++k) {
+        threads.unpin(_records[(_head + k) % _records.size()].threadIndex);
+    }
+    _head = 0;
+    _size = 0;
+}
+
+std::size_t RingBufferSink::getSize() const
+{
+    std::lock_guard lock(_mutex);
+
+    return _size;
+}
+
+void RingBufferSink::writeHeader(
+    const std::string& projectName,
+    const int argc,
+    const char* argv[],
+    const BuildInfo& buildInfo,
+    const Settings& settings
+)
+{
+    if (_target) {
+        _target->writeHeader(projectName, argc, argv, buildInfo, settings);
+    }
+}
+
+void RingBufferSink::flush()
+{
+    // retained logs are only written by dumps, which flush the target.
+}
+
+void RingBufferSink::close()
+{
+    std::lock_guard lock(_mutex);
+
+    if (_target) {
+        _target->close();
+    }
+}
+
+}
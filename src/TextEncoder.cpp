@@ -0,0 +1,119 @@
+#include <format>
+#include <iterator>
+
+#include "logger/TextEncoder.h"
+
+namespace logger::text
+{
+
+    /**
+     * @brief   Appends everything that comes before the source of a line.
+     */
+    static void appendHead(
+        std::string& out,
+        const LogFields& log,
+        const sink::Settings& settings,
+        TimestampRenderer& timestampRenderer
+    )
+    {
+        if (settings.showTimestamp) {
+            timestampRenderer.renderTo(
+                out,
+                log.timestamp,
+                settings.showOnlyTime,
+                settings.showMilliseconds
+            );
+            out += ' ';
+        }
+
+        if (settings.showThreadInfo) {
+            out += '[';
+            out += log.threadName;
+            if (settings.showThreadId) {
+                out += " (";
+                out += log.threadId;
+                out += ')';
+            }
+            out += "] ";
+        }
+
+        std::format_to(std::back_inserter(out),
+            "{:>8}: ",
+            level::to_string(log.level)
+        );
+
+        out += log.message;
+    }
+
+    /**
+     * @brief   Appends the source of a line, which only depends on its call
+     *          site.
+     */
+    static void appendSource(
+        std::string& out,
+        const std::string_view file,
+        const uint64_t line,
+        const uint64_t column,
+        const sink::Settings& settings
+    )
+    {
+        if (settings.showSource) {
+            out += " (";
+            out += file;
+
+            if (settings.showLineNumber) {
+                std::format_to(std::back_inserter(out),
+                    ":{}",
+                    line
+                );
+            }
+            if (settings.showColumnNumber) {
+                std::format_to(std::back_inserter(out),
+                    ":{}",
+                    column
+                );
+            }
+            out += ")";
+        }
+    }
+
+    void appendLog(
+        std::string& out,
+        const LogFields& log,
+        const sink::Settings& settings,
+        TimestampRenderer& timestampRenderer
+    )
+    {
+        appendHead(out, log, settings, timestampRenderer);
+        appendSource(out, log.file, log.line, log.column, settings);
+        out += "\n";
+    }
+
+    void appendLog(
+        std::string& out,
+        const Log& log,
+        const sink::Settings& settings,
+        TimestampRenderer& timestampRenderer
+    )
+    {
+        appendLog(out, LogFields::from(log), settings, timestampRenderer);
+    }
+
+    void appendLog(
+        std::string& out,
+        const Log& log,
+        const sink::Settings& settings,
+        TimestampRenderer& timestampRenderer,
+        CallsiteCache& sources
+    )
+    {
+        const LogFields fields = LogFields::from(log);
+
+        appendHead(out, fields, settings, timestampRenderer);
+        out += sources.get(log.getCallsite(), [&](std::string& source) {
+            appendSource(source, fields.file, fields.line, fields.column, settings);
+        });
+        out += "\n";
+    }
+
+}
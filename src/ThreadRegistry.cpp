@@ -0,0 +1,190 @@
+#include <format>
+
+#include "logger/ThreadRegistry.h"
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace logger
+{
+
+static uint64_t getOsThreadId()
+{
+#if defined(__linux__)
+    return static_cast<uint64_t>(::syscall(SYS_gettid));
+#elif defined(__APPLE__)
+    uint64_t id = 0;
+    pthread_threadid_np(nullptr, &id);
+    return id;
+#elif defined(_WIN32)
+    return static_cast<uint64_t>(GetCurrentThreadId());
+#else
+    return 0;
+#endif
+}
+
+ThreadRegistry& ThreadRegistry::getInstance()
+{
+    // never destroyed: threads may still log while static objects are torn down.
+    static ThreadRegistry* instance = new ThreadRegistry();
+    return *instance;
+}
+
+ThreadRegistry::ThreadRegistry()
+    : _unknown{ 0, std::thread::id(), 0, "Unknown", "0x0" }
+{}
+
+uint32_t ThreadRegistry::registerCurrentThread(const char* label)
+{
+    const std::thread::id id = std::this_thread::get_id();
+    auto info = std::make_unique<ThreadInfo>(ThreadInfo{
+        0,
+        id,
+        getOsThreadId(),
+        label,
+        std::format("0x{:x}", std::hash<std::thread::id>{}(id)),
+    });
+
+    std::lock_guard lock(_mutex);
+
+    if (!_freeIndices.empty()) {
+        info->index = _freeIndices.back();
+        _freeIndices.pop_back();
+    } else if (_nextIndex < kChunkSize * kMaxChunks) {
+        info->index = _nextIndex++;
+    } else {
+        return 0;
+    }
+
+    const uint32_t index = info->index;
+
+    publish(std::move(info));
+    return index;
+}
+
+void ThreadRegistry::relabel(const uint32_t index, const char* label)
+{
+    std::lock_guard lock(_mutex);
+    const ThreadInfo& current = get(index);
+
+    if (current.index == 0) {
+        return;
+    }
+    publish(std::make_unique<ThreadInfo>(ThreadInfo{
+        current.index,
+        current.id,
+        current.osId,
+        label,
+        current.prettyId,
+    }));
+}
+
+void ThreadRegistry::release(const uint32_t index)
+{
+    std::lock_guard lock(_mutex);
+    Slot* slot = findSlot(index);
+
+    if (!slot || !slot->owned) {
+        return;
+    }
+
+    // the snapshot stays published: logs still queued keep displaying it.
+    _retired.push_back({ std::move(slot->owned), _epoch, true });
+}
+
+void ThreadRegistry::pin(const uint32_t index)
+{
+    if (Slot* slot = findSlot(index)) {
+        slot->pins.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+void ThreadRegistry::unpin(const uint32_t index)
+{
+    if (Slot* slot = findSlot(index)) {
+        slot->pins.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+uint64_t ThreadRegistry::advanceEpoch()
+{
+    std::lock_guard lock(_mutex);
+
+    return ++_epoch;
+}
+
+void ThreadRegistry::reclaim(const uint64_t epoch)
+{
+    std::lock_guard lock(_mutex);
+
+    std::erase_if(_retired, [&](Retired& retired) {
+        Slot* slot = findSlot(retired.info->index);
+
+        if (retired.epoch >= epoch || slot->pins.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        if (retired.isReleased) {
+            slot->info.store(nullptr, std::memory_order_release);
+            _freeIndices.push_back(retired.info->index);
+        }
+        return true;
+    });
+}
+
+const ThreadInfo& ThreadRegistry::get(const uint32_t index) const
+{
+    if (index == 0 || index >= kChunkSize * kMaxChunks) {
+        return _unknown;
+    }
+
+    const Chunk* chunk = _chunks[index / kChunkSize].load(std::memory_order_acquire);
+
+    if (!chunk) {
+        return _unknown;
+    }
+
+    const ThreadInfo* info = (*chunk)[index % kChunkSize].info.load(std::memory_order_acquire);
+
+    return info ? *info : _unknown;
+}
+
+ThreadRegistry::Slot* ThreadRegistry::findSlot(const uint32_t index)
+{
+    if (index == 0 || index >= kChunkSize * kMaxChunks) {
+        return nullptr;
+    }
+
+    Chunk* chunk = _chunks[index / kChunkSize].load(std::memory_order_acquire);
+
+    return chunk ? &(*chunk)[index % kChunkSize] : nullptr;
+}
+
+void ThreadRegistry::publish(std::unique_ptr<ThreadInfo> info)
+{
+    const std::size_t chunkIndex = info->index / kChunkSize;
+    Chunk* chunk = _chunks[chunkIndex].load(std::memory_order_relaxed);
+
+    if (!chunk) {
+        _ownedChunks.push_back(std::make_unique<Chunk>());
+        chunk = _ownedChunks.back().get();
+        _chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    Slot& slot = (*chunk)[info->index % kChunkSize];
+
+    info->version = _nextVersion++;
+    slot.info.store(info.get(), std::memory_order_release);
+    // sinks may still be reading the previous snapshot.
+    if (slot.owned) {
+        _retired.push_back({ std::move(slot.owned), _epoch, false });
+    }
+    slot.owned = std::move(info);
+}
+
+}
@@ -1,5 +1,7 @@
 #include <chrono>
+#include <format>
 #include <iomanip>
+#include <iterator>
 
 #include "logger/Timestamp.h"
 
@@ -26,9 +28,9 @@ std::string formatTimestamp(
     std::string out;
     out.reserve(32);
 
-    const std::tm tm = fromTimePoint(timestamp);
-
     if (forFilename) {
+        const std::tm tm = fromTimePoint(timestamp);
+
         std::format_to(std::back_inserter(out),
             "{:04}-{:02}-{:02}_{:02}-{:02}-{:02}",
             tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
@@ -37,25 +39,48 @@ std::string formatTimestamp(
         return out;
     }
 
-    if (showOnlyTime) {
-        std::format_to(std::back_inserter(out),
-            "{:02}:{:02}:{:02}",
-            tm.tm_hour, tm.tm_min, tm.tm_sec
-        );
-    } else {
-        std::format_to(std::back_inserter(out),
+    // one renderer per thread, so that callers still benefit from the cache.
+    thread_local TimestampRenderer renderer;
+
+    renderer.renderTo(out, timestamp, showOnlyTime, showMilliseconds);
+    return out;
+}
+
+void TimestampRenderer::renderTo(
+    std::string& out,
+    const time_point<system_clock> timestamp,
+    const bool showOnlyTime,
+    const bool showMilliseconds
+)
+{
+    const auto second = floor<seconds>(timestamp);
+
+    if (second != _cachedSecond) {
+        const std::tm tm = fromTimePoint(second);
+
+        std::format_to_n(_dateTime, kDateTimeSize,
             "{:04}-{:02}-{:02} {:02}:{:02}:{:02}",
             tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
             tm.tm_hour, tm.tm_min, tm.tm_sec
         );
+        _cachedSecond = second;
+    }
+
+    if (showOnlyTime) {
+        out.append(_dateTime + kDateSize, kDateTimeSize - kDateSize);
+    } else {
+        out.append(_dateTime, kDateTimeSize);
     }
 
     if (showMilliseconds) {
-        const auto ms =
-            duration_cast<milliseconds>(timestamp.time_since_epoch()) % 1000;
+        const auto ms = static_cast<int>(duration_cast<milliseconds>(timestamp - second).count());
+        const char digits[] = {
+            '.',
+            static_cast<char>('0' + ms / 100),
+            static_cast<char>('0' + ms / 10 % 10),
+            static_cast<char>('0' + ms % 10),
+        };
 
-        std::format_to(std::back_inserter(out), ".{:03}", ms.count());
+        out.append(digits, sizeof(digits));
     }
-
-    return out;
 }
@@ -0,0 +1,69 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+/**
+ * @brief   Held back logs are only queued when their thread errors: the
+ *          last ones, oldest first, right before the error.
+ */
+int main(const int argc, const char* argv[])
+{
+    using namespace logger;
+
+    Settings settings;
+    bool isRejected = false;
+
+    // a log can't be both held back and the trigger.
+    try {
+        settings.setBacktrace(4, Level::kError, Level::kError);
+    } catch (const exception::InvalidLevel&) {
+        isRejected = true;
+    }
+    CHECK(isRejected);
+
+    settings.setBacktrace(4, Level::kDebug, Level::kError);
+
+    const auto sink = Logger::getInstance().addSink<TestSink>();
+
+    Logger::initialize("Backtrace", argc, argv, BuildInfo::unknown(), settings);
+
+    // a thread that never errors queues nothing it held back.
+    std::thread([] {
+        for (int k = 0; k < 3; ++k) {
+            LOG_DEBUG("quiet {}", k);
+        }
+        LOG_INFO("quiet thread done");
+    }).join();
+
+    for (int k = 0; k < 6; ++k) {
+        LOG_DEBUG("debug {}", k);
+    }
+    LOG_INFO("info");
+    LOG_ERR("error");
+    LOG_DEBUG("after");
+
+    Logger::getInstance().shutdown();
+
+    std::vector<std::string> messages = sink->getMessages();
+
+    // the shutdown notice.
+    CHECK(!messages.empty() && messages.back().starts_with("Shutting down"));
+    if (!messages.empty()) {
+        messages.pop_back();
+    }
+    CHECK(messages == std::vector<std::string>({
+        "quiet thread done",
+        "info",
+        "debug 2",
+        "debug 3",
+        "debug 4",
+        "debug 5",
+        "error",
+    }));
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include "logger/Logger.h"
+#include "logger/Sinks/BinaryFileSink.h"
+#include "logger/Sinks/LogFileSink.h"
+#include "logger/Sinks/NdJsonFileSink.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+static std::string readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+/**
+ * @return  The logs of a text file, without its header.
+ */
+static std::string skipLogHeader(const std::string& content)
+{
+    const std::size_t end = content.find("\\*************************************************\n\n");
+
+    return end == std::string::npos ? std::string() : content.substr(end + 51);
+}
+
+/**
+ * @return  The logs of a NDJSON file, without its header line.
+ */
+static std::string skipNdJsonHeader(const std::string& content)
+{
+    const std::size_t end = content.find('\n');
+
+    return end == std::string::npos ? std::string() : content.substr(end + 1);
+}
+
+/**
+ * @brief   Decoding a binary file gives back what the text sinks wrote, with
+ *          the binary sink's settings.
+ *
+ * @param   argv    The path of shuvlog-decode, as first argument
+ */
+int main(const int argc, const char* argv[])
+{
+    if (argc < 2) {
+        return 1;
+    }
+
+    const std::string decoder = argv[1];
+    logger::sink::Settings settings;
+
+    settings.showOnlyTime = true;
+    settings.showColumnNumber = false;
+    settings.showThreadId = false;
+
+    std::filesystem::remove_all("round_trip");
+    std::filesystem::create_directories("round_trip");
+
+    Logger& logger = Logger::getInstance();
+
+    logger.addSink<logger::BinaryFileSink>("round_trip/binary.shlog", settings);
+    logger.addSink<logger::LogFileSink>("round_trip/text.log", settings);
+    logger.addSink<logger::NdJsonFileSink>("round_trip/text.ndjson", settings);
+    Logger::initialize("BinaryRoundTrip", argc, argv, logger::BuildInfo::unknown(), logger::Settings());
+
+    for (int k = 0; k < 1000; ++k) {
+        LOG_INFO("request {} served in {} us", k, k * 3);
+        if (k % 100 == 0) {
+            LOG_WARN("quotes \" backslashes \\ and control characters \t\x01 {}", 'c');
+        }
+    }
+    for (int k = 0; k < 10; ++k) {
+        LOG_WARN_SAMPLED(2, "sampled {}", k);
+    }
+
+    std::thread([] {
+        logger::setThreadLabel("Other");
+        LOG_ERR("from another thread");
+        logger::setThreadLabel("Relabeled");
+        LOG_ERR("from a relabeled thread");
+    }).join();
+
+    logger.shutdown();
+
+    CHECK(std::system((decoder + " round_trip/binary.shlog").c_str()) == 0);
+    CHECK(std::system((decoder + " --format ndjson --jobs 4 round_trip/binary.shlog").c_str()) == 0);
+
+    const std::string log = skipLogHeader(readFile("round_trip/text.log"));
+    const std::string ndjson = skipNdJsonHeader(readFile("round_trip/text.ndjson"));
+
+    CHECK(!log.empty() && log == skipLogHeader(readFile("round_trip/binary.log")));
+    CHECK(!ndjson.empty() && ndjson == skipNdJsonHeader(readFile("round_trip/binary.ndjson")));
+    // the binary file is the smallest of them.
+    CHECK(std::filesystem::file_size("round_trip/binary.shlog") < log.size());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "logger/Logger.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+static std::size_t count(const std::vector<std::string>& messages, const std::string& message)
+{
+    return static_cast<std::size_t>(std::count(messages.begin(), messages.end(), message));
+}
+
+static std::size_t countPrefix(const std::vector<std::string>& messages, const std::string& prefix)
+{
+    return static_cast<std::size_t>(std::ranges::count_if(messages, [&](const std::string& message) {
+        return message.starts_with(prefix);
+    }));
+}
+
+static std::ptrdiff_t indexOf(const std::vector<std::string>& messages, const std::string& message)
+{
+    return std::ranges::find(messages, message) - messages.begin();
+}
+
+static void warn(const int i)
+{
+    LOG_WARN("warning flood {}", i);
+}
+
+int main(const int argc, const char* argv[])
+{
+    using namespace logger;
+
+    // hashed without formatting: plain characters are numbers, character
+    // pointers are strings (a null one included).
+    static_assert(CallsiteLimiter::kHashable<char, const char*, char[4], int>);
+    CHECK(CallsiteLimiter::hashArgs(42, 'c') == CallsiteLimiter::hashArgs(42, 'c'));
+    CHECK(CallsiteLimiter::hashArgs('a') != CallsiteLimiter::hashArgs('b'));
+    CHECK(CallsiteLimiter::hashArgs(static_cast<const char*>(nullptr)) != CallsiteLimiter::hashArgs(""));
+
+    const auto sink = Logger::getInstance().addSink<TestSink>();
+    Settings settings;
+
+    settings.setCollapseRepeats(true);
+    // DEBUG call sites get the global limit, the other levels their own.
+    settings.setRateLimit(RateLimit{ .logsPerSecond = 1, .burst = 5 });
+    settings.setRateLimit(Level::kError, RateLimit{ .logsPerSecond = 1, .burst = 2 });
+    settings.setRateLimit(Level::kWarning, RateLimit{ .logsPerSecond = 20, .burst = 1 });
+    settings.setRateLimit(Level::kInfo, RateLimit{ .logsPerSecond = 1'000'000, .burst = 1'000 });
+    Logger::initialize("CallsiteLimiter", argc, argv, BuildInfo::unknown(), settings);
+
+    for (int i = 0; i < 10; ++i) {
+        LOG_INFO("char {}", 'c');
+    }
+    LOG_INFO("char {}", 'd');
+
+    // a flooding call site keeps its burst, and the rest is suppressed...
+    for (int i = 0; i < 100; ++i) {
+        LOG_DEBUG("debug flood {}", i);
+    }
+    for (int i = 0; i < 10; ++i) {
+        LOG_ERR("error flood {}", i);
+    }
+
+    // ...until its bucket refills (1 log every 50 ms): the next accepted log
+    // tells how many have been suppressed.
+    for (int i = 0; i < 5; ++i) {
+        warn(i);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    warn(5);
+
+    Logger::getInstance().shutdown();
+
+    const std::vector<std::string> messages = sink->getMessages();
+
+    CHECK(count(messages, "char c") == 1);
+    CHECK(count(messages, "Last message repeated 9 times.") == 1);
+    CHECK(count(messages, "char d") == 1);
+
+    CHECK(countPrefix(messages, "debug flood") == 5);
+    CHECK(countPrefix(messages, "error flood") == 2);
+    // told at shutdown, as nothing was accepted afterward.
+    CHECK(count(messages, "95 logs suppressed by the rate limit of this call site.") == 1);
+    CHECK(count(messages, "8 logs suppressed by the rate limit of this call site.") == 1);
+
+    const std::ptrdiff_t suppressed = indexOf(messages, "4 logs suppressed by the rate limit of this call site.");
+
+    CHECK(countPrefix(messages, "warning flood") == 2);
+    CHECK(suppressed == indexOf(messages, "warning flood 0") + 1);
+    CHECK(suppressed + 1 == indexOf(messages, "warning flood 5"));
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <string>
+
+#include "logger/Logger.h"
+#include "TestSink.h"
+
+static int failures = 0;
+static int evaluations = 0;
+
+static int countEvaluation()
+{
+    return ++evaluations;
+}
+
+namespace net
+{
+
+    struct Session
+    {
+        static void handshake(const int step)
+        {
+            LOG_INFO("handshake {} ({})", step, countEvaluation());
+        }
+    };
+
+}
+
+static void parse(const int step)
+{
+    LOG_INFO("parse {} ({})", step, countEvaluation());
+}
+
+static int rateEvaluations = 0;
+
+static void sample()
+{
+    LOG_WARN_SAMPLED((++rateEvaluations, 1), "sampled");
+}
+
+int main(const int argc, const char* argv[])
+{
+    using namespace logger;
+
+    const auto sink = Logger::getInstance().addSink<TestSink>();
+    auto& callsites = Logger::getInstance().getCallsiteRegistry();
+
+    Logger::initialize("CallsiteRegistry", argc, argv, BuildInfo::unknown(), Settings());
+
+    // a rule applies to the call sites registered later, which don't even
+    // evaluate their arguments once.
+    CHECK(callsites.disable({ .function = "Session::handshake" }) == 0);
+    net::Session::handshake(1);
+    parse(1);
+    CHECK(evaluations == 1);
+
+    // and to the ones registered so far.
+    CHECK(callsites.enable({ .function = "handshake" }) == 1);
+    CHECK(callsites.disable({ .file = "CallsiteRegistry.cpp", .levels = SHUVLOG_LEVEL_INFO }) == 2);
+    net::Session::handshake(2);
+    parse(2);
+    CHECK(evaluations == 1);
+
+    // filters select call sites by line range and level too.
+    CHECK(callsites.enable({ .file = "*Registry.cpp", .firstLine = 0, .lastLine = 25 }) == 1);
+    CHECK(callsites.enable({ .levels = SHUVLOG_LEVEL_ERROR }) == 0);
+    net::Session::handshake(3);
+    parse(3);
+    CHECK(evaluations == 2);
+
+    std::size_t count = 0;
+
+    callsites.forEach([&](const Callsite& site) {
+        if (site.file.ends_with("CallsiteRegistry.cpp")) {
+            ++count;
+        }
+    });
+    CHECK(count == 2);
+
+    // a disabled sampled call site doesn't evaluate its rate either.
+    sample();
+    CHECK(rateEvaluations == 1);
+    CHECK(callsites.disable({ .function = "sample" }) == 1);
+    sample();
+    sample();
+    CHECK(rateEvaluations == 1);
+
+    Logger::getInstance().shutdown();
+
+    const std::vector<std::string> messages = sink->getMessages();
+
+    CHECK(std::ranges::count(messages, std::string("handshake 3 (2)")) == 1);
+    CHECK(std::ranges::count_if(messages, [](const std::string& message) {
+        return message.starts_with("parse");
+    }) == 1);
+    return failures == 0 ? 0 : 1;
+}
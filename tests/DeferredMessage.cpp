@@ -0,0 +1,48 @@
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "logger/DeferredMessage.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+enum class Color { kRed };
+
+struct Point
+{
+    int x;
+    int y;
+};
+
+using logger::DeferredMessage;
+
+// values that can't reference other memory are captured...
+static_assert(DeferredMessage::kCapturable<int, double, bool, char, Color>);
+static_assert(DeferredMessage::kCapturable<void*, const void*, std::nullptr_t>);
+static_assert(DeferredMessage::kCapturable<std::chrono::milliseconds, std::chrono::system_clock::time_point>);
+static_assert(DeferredMessage::kCapturable<std::string, const std::string&>);
+// ...anything that may dangle isn't...
+static_assert(!DeferredMessage::kCapturable<const char*>);
+static_assert(!DeferredMessage::kCapturable<const char (&)[6]>);
+static_assert(!DeferredMessage::kCapturable<std::string_view>);
+static_assert(!DeferredMessage::kCapturable<std::wstring_view>);
+static_assert(!DeferredMessage::kCapturable<std::u8string_view>);
+static_assert(!DeferredMessage::kCapturable<std::span<const int>>);
+static_assert(!DeferredMessage::kCapturable<std::vector<int>::iterator>);
+// ...and neither are user types, unless they opt in.
+static_assert(!DeferredMessage::kCapturable<Point>);
+
+int main()
+{
+    std::string text = "text";
+    const DeferredMessage message("{} {} {}", 42, 1.5, text);
+
+    // captured by copy: changing the original doesn't change the message.
+    text = "changed";
+    CHECK(message.render() == "42 1.5 text");
+    return failures == 0 ? 0 : 1;
+}
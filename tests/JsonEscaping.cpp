@@ -0,0 +1,129 @@
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "logger/JsonEncoder.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+/**
+ * @return  A string escaped one character at a time, as appendEscaped()
+ *          should do it whatever the instruction set.
+ */
+static std::string escapeSlowly(const std::string_view value)
+{
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+    std::string out;
+
+    for (const char c : value) {
+        switch (c) {
+            case '"':   out += R"(\")"; break;
+            case '\\':  out += R"(\\)"; break;
+            case '\n':  out += R"(\n)"; break;
+            case '\r':  out += R"(\r)"; break;
+            case '\t':  out += R"(\t)"; break;
+            case '\b':  out += R"(\b)"; break;
+            case '\f':  out += R"(\f)"; break;
+            default:
+                if (static_cast<uint8_t>(c) < 0x20) {
+                    out += R"(\u00)";
+                    out += kHexDigits[(c >> 4) & 0xF];
+                    out += kHexDigits[c & 0xF];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+/**
+ * @return  The bytes of an escaped JSON string (without its quotes), or
+ *          nothing if it isn't valid JSON.
+ */
+static std::optional<std::string> unescape(const std::string_view escaped)
+{
+    std::string out;
+
+    for (std::size_t i = 0; i < escaped.size(); ++i) {
+        const char c = escaped[i];
+
+        if (static_cast<uint8_t>(c) < 0x20 || c == '"') {
+            return std::nullopt;
+        }
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (++i == escaped.size()) {
+            return std::nullopt;
+        }
+        switch (escaped[i]) {
+            case '"':   out += '"'; break;
+            case '\\':  out += '\\'; break;
+            case '/':   out += '/'; break;
+            case 'n':   out += '\n'; break;
+            case 'r':   out += '\r'; break;
+            case 't':   out += '\t'; break;
+            case 'b':   out += '\b'; break;
+            case 'f':   out += '\f'; break;
+            case 'u': {
+                if (i + 4 >= escaped.size()) {
+                    return std::nullopt;
+                }
+
+                const unsigned long code = std::stoul(std::string(escaped.substr(i + 1, 4)), nullptr, 16);
+
+                // only control characters are escaped this way.
+                if (code >= 0x20) {
+                    return std::nullopt;
+                }
+                out += static_cast<char>(code);
+                i += 4;
+                break;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief   Escaping random strings gives the same output as escaping them
+ *          one character at a time, and valid JSON that decodes back to the
+ *          original bytes.
+ *
+ * Lengths go past 2 * 32 bytes, so that the vectorized loops and their
+ * scalar tail all get exercised.
+ */
+int main()
+{
+    std::mt19937 random(20'000);
+    std::uniform_int_distribution<std::size_t> length(0, 100);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::string out;
+
+    for (int k = 0; k < 20'000; ++k) {
+        std::string value(length(random), '\0');
+
+        // mostly clean text, so that runs are long enough to be copied at once.
+        for (char& c : value) {
+            c = kind(random) < 8 ? static_cast<char>('a' + byte(random) % 26) : static_cast<char>(byte(random));
+        }
+
+        out = "prefix";
+        logger::json::appendEscaped(out, value);
+
+        const std::string_view escaped = std::string_view(out).substr(6);
+
+        CHECK(out.starts_with("prefix"));
+        CHECK(escaped == escapeSlowly(value));
+        CHECK(unescape(escaped) == value);
+    }
+    return failures == 0 ? 0 : 1;
+}
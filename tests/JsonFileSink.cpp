@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "logger/Sinks/JsonFileSink.h"
+#include "TestSink.h"
+
+namespace fs = std::filesystem;
+
+static int failures = 0;
+
+static const logger::Callsite& info = SHUVLOG_CALLSITE(logger::Level::kInfo);
+
+/**
+ * @struct  Json
+ * @brief   A parsed JSON value, of which the tests only look at objects,
+ *          arrays and strings.
+ */
+struct Json
+{
+    /// @return The member of an object, if it has one with this key.
+    [[nodiscard]] const Json* get(const std::string_view key) const
+    {
+        const auto it = std::ranges::find(keys, key);
+
+        return it == keys.end() ? nullptr : &members[static_cast<std::size_t>(it - keys.begin())];
+    }
+
+    std::vector<std::string> keys;
+    std::vector<Json> members;
+    std::vector<Json> array;
+    std::string string;
+};
+
+/**
+ * @class   JsonParser
+ * @brief   Strict JSON parser: any syntax error fails the whole document.
+ */
+class JsonParser final
+{
+public:
+    explicit JsonParser(const std::string& text) : _text(text) {}
+
+    /// @return The document, or nothing if it isn't valid JSON.
+    std::optional<Json> parse()
+    {
+        std::optional<Json> value = parseValue();
+
+        skipSpaces();
+        if (!value || _position != _text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    void skipSpaces()
+    {
+        while (_position < _text.size() && std::isspace(static_cast<unsigned char>(_text[_position]))) {
+            ++_position;
+        }
+    }
+
+    bool consume(const char c)
+    {
+        skipSpaces();
+        if (_position < _text.size() && _text[_position] == c) {
+            ++_position;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeWord(const std::string& word)
+    {
+        if (_text.compare(_position, word.size(), word) != 0) {
+            return false;
+        }
+        _position += word.size();
+        return true;
+    }
+
+    std::optional<Json> parseValue()
+    {
+        skipSpaces();
+        if (_position == _text.size()) {
+            return std::nullopt;
+        }
+
+        const char c = _text[_position];
+
+        if (c == '{') {
+            return parseObject();
+        }
+        if (c == '[') {
+            return parseArray();
+        }
+        if (c == '"') {
+            std::optional<std::string> string = parseString();
+
+            return string ? std::optional<Json>(Json{ .string = *string }) : std::nullopt;
+        }
+        if (consumeWord("true") || consumeWord("false") || consumeWord("null")) {
+            return Json{};
+        }
+        return parseNumber();
+    }
+
+    std::optional<Json> parseObject()
+    {
+        Json json;
+
+        ++_position;
+        if (consume('}')) {
+            return json;
+        }
+        do {
+            skipSpaces();
+
+            std::optional<std::string> key = parseString();
+
+            if (!key || !consume(':')) {
+                return std::nullopt;
+            }
+
+            std::optional<Json> value = parseValue();
+
+            if (!value) {
+                return std::nullopt;
+            }
+            json.keys.push_back(std::move(*key));
+            json.members.push_back(std::move(*value));
+        } while (consume(','));
+        return consume('}') ? std::optional<Json>(std::move(json)) : std::nullopt;
+    }
+
+    std::optional<Json> parseArray()
+    {
+        Json json;
+
+        ++_position;
+        if (consume(']')) {
+            return json;
+        }
+        do {
+            std::optional<Json> value = parseValue();
+
+            if (!value) {
+                return std::nullopt;
+            }
+            json.array.push_back(std::move(*value));
+        } while (consume(','));
+        return consume(']') ? std::optional<Json>(std::move(json)) : std::nullopt;
+    }
+
+    std::optional<std::string> parseString()
+    {
+        std::string string;
+
+        if (_position == _text.size() || _text[_position++] != '"') {
+            return std::nullopt;
+        }
+        while (_position < _text.size()) {
+            const char c = _text[_position++];
+
+            if (c == '"') {
+                return string;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return std::nullopt;
+            }
+            if (c != '\\') {
+                string += c;
+                continue;
+            }
+            if (_position == _text.size()) {
+                return std::nullopt;
+            }
+            switch (const char escaped = _text[_position++]) {
+                case '"': case '\\': case '/': string += escaped; break;
+                case 'n': string += '\n'; break;
+                case 'r': string += '\r'; break;
+                case 't': string += '\t'; break;
+                case 'b': string += '\b'; break;
+                case 'f': string += '\f'; break;
+                case 'u':
+                    if (_position + 4 > _text.size()) {
+                        return std::nullopt;
+                    }
+                    string += static_cast<char>(std::stoi(_text.substr(_position, 4), nullptr, 16));
+                    _position += 4;
+                    break;
+                default:
+                    return std::nullopt;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Json> parseNumber()
+    {
+        const std::size_t start = _position;
+
+        if (_position < _text.size() && _text[_position] == '-') {
+            ++_position;
+        }
+        while (_position < _text.size()
+            && (std::isdigit(static_cast<unsigned char>(_text[_position])) || std::string_view(".eE+-").contains(_text[_position]))) {
+            ++_position;
+        }
+        return _position != start ? std::optional<Json>(Json{}) : std::nullopt;
+    }
+
+    const std::string& _text;
+    std::size_t _position = 0;
+};
+
+static std::optional<Json> parseFile(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    const std::string text(std::istreambuf_iterator<char>(file), {});
+
+    return JsonParser(text).parse();
+}
+
+/**
+ * @return  The messages of a parsed document, or nothing if it isn't a log
+ *          file.
+ */
+static std::optional<std::vector<std::string>> getMessages(const std::optional<Json>& document)
+{
+    const Json* logs = document ? document->get("logs") : nullptr;
+
+    if (logs == nullptr) {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> messages;
+
+    for (const Json& entry : logs->array) {
+        const Json* message = entry.get("message");
+
+        if (message == nullptr) {
+            return std::nullopt;
+        }
+        messages.push_back(message->string);
+    }
+    return messages;
+}
+
+/**
+ * @brief   The document is valid JSON whenever it is at rest: after the
+ *          header, after each flush, after a rotation (in both the rotated
+ *          and the new file), and after closing. No log is lost on the way.
+ */
+int main(const int argc, const char* argv[])
+{
+    constexpr int kBatches = 40;
+    constexpr int kLogsPerBatch = 10;
+
+    fs::remove_all("json_sink");
+    fs::create_directories("json_sink");
+
+    auto sink = std::make_shared<logger::JsonFileSink>("json_sink/logs.json");
+
+    sink->setRotationPolicy({ .maxBytes = 8 * 1024, .compression = logger::sink::Compression::kNone });
+    sink->writeHeader("JsonFileSink", argc, argv, logger::BuildInfo::unknown(), logger::Settings());
+    sink->flush();
+    CHECK(getMessages(parseFile("json_sink/logs.json")) == std::vector<std::string>());
+
+    std::vector<std::string> expected;
+
+    for (int batch = 0; batch < kBatches; ++batch) {
+        std::vector<Log> logs;
+
+        for (int k = 0; k < kLogsPerBatch; ++k) {
+            expected.push_back(std::format("batch {} \"log\" {}\n", batch, k));
+            logs.emplace_back(expected.back(), info);
+        }
+        sink->writeBatch(logs);
+        sink->flush();
+        CHECK(getMessages(parseFile("json_sink/logs.json")).has_value());
+    }
+    sink->close();
+    // destroying the sink waits for its rotation thread.
+    sink.reset();
+
+    std::vector<std::vector<std::string>> files;
+
+    for (const auto& entry : fs::directory_iterator("json_sink")) {
+        const std::optional<std::vector<std::string>> fileMessages = getMessages(parseFile(entry.path()));
+
+        CHECK(fileMessages.has_value());
+        if (fileMessages) {
+            files.push_back(*fileMessages);
+        }
+    }
+    CHECK(files.size() > 2);
+
+    // files in the order of their first log, whatever their name.
+    std::ranges::sort(files, {}, [&](const std::vector<std::string>& fileMessages) {
+        return fileMessages.empty() ? -1 : std::ranges::find(expected, fileMessages.front()) - expected.begin();
+    });
+
+    std::vector<std::string> messages;
+
+    for (const std::vector<std::string>& fileMessages : files) {
+        messages.insert(messages.end(), fileMessages.begin(), fileMessages.end());
+    }
+    CHECK(messages == expected);
+    return failures == 0 ? 0 : 1;
+}
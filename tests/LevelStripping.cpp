@@ -0,0 +1,51 @@
+// Stripping everything below INFO, whatever the library has been configured with.
+#undef SHUVLOG_ACTIVE_LEVEL
+#define SHUVLOG_ACTIVE_LEVEL SHUVLOG_LEVEL_INFO
+
+#include <type_traits>
+
+#include "logger/Logger.h"
+#include "logger/Sinks/ConsoleSink.h"
+
+/**
+ * Declared, but never defined anywhere.
+ * If a stripped call site generated any code for its arguments, this test
+ * would fail to link.
+ */
+int neverDefined();
+
+static int evaluations = 0;
+
+static int countEvaluation()
+{
+    return ++evaluations;
+}
+
+// stripped call sites are plain void expressions.
+static_assert(std::is_void_v<decltype(LOG_DEBUG("{}", neverDefined()))>);
+
+int main(const int argc, const char* argv[])
+{
+    using namespace logger;
+
+    Logger::getInstance().addSink<ConsoleSink>();
+    Logger::initialize("LevelStripping", argc, argv, BuildInfo::unknown());
+
+    LOG_DEBUG("{}", neverDefined());
+    LOG_TRACE_R3("{}", neverDefined());
+    LOG_TRACE_R2("{}", neverDefined());
+    LOG_TRACE_R1("{}", neverDefined());
+
+    LOG_DEBUG("{}", countEvaluation());
+    LOG_TRACE_R3("{}", countEvaluation());
+    LOG_TRACE_R2("{}", countEvaluation());
+    LOG_TRACE_R1("{}", countEvaluation());
+
+    // stripped call sites don't evaluate their arguments.
+    const int strippedEvaluations = evaluations;
+
+    LOG_INFO("Evaluation #{} (should be the first one).", countEvaluation());
+
+    Logger::getInstance().shutdown();
+    return strippedEvaluations == 0 && evaluations == 1 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "logger/LogArena.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+/**
+ * @brief   Released allocations give their slab back: allocating over and
+ *          over doesn't grow the arena.
+ */
+static void testRecycling()
+{
+    logger::LogArena arena;
+    std::vector<void*> allocations;
+
+    for (int round = 0; round < 100; ++round) {
+        for (int k = 0; k < 1000; ++k) {
+            void* memory = arena.allocate(100);
+
+            std::memset(memory, round, 100);
+            allocations.push_back(memory);
+        }
+        for (void* memory : allocations) {
+            logger::LogArena::release(memory);
+        }
+        allocations.clear();
+    }
+    // 100 KB live at once at most: a handful of slabs, not one per round.
+    CHECK(arena.getSlabCount() <= 4);
+    CHECK(arena.allocate(logger::LogArena::kMaxAllocation + 1) == nullptr);
+}
+
+/**
+ * @brief   Memory allocated by a thread can be released by another one.
+ */
+static void testCrossThreadRelease()
+{
+    logger::LogArena arena;
+    std::vector<void*> allocations;
+
+    for (int round = 0; round < 50; ++round) {
+        std::thread([&] {
+            for (int k = 0; k < 1000; ++k) {
+                allocations.push_back(arena.allocate(64));
+            }
+        }).join();
+        for (void* memory : allocations) {
+            logger::LogArena::release(memory);
+        }
+        allocations.clear();
+    }
+    CHECK(arena.getSlabCount() <= 4);
+}
+
+/**
+ * @brief   Threads and allocations outliving their arena still release their
+ *          slabs safely (e.g. threads still running after the Logger is
+ *          destroyed).
+ */
+static void testOutlivingArena()
+{
+    auto arena = std::make_unique<logger::LogArena>();
+    std::atomic<int> step{0};
+    void* first = nullptr;
+    void* second = nullptr;
+
+    std::thread thread([&] {
+        first = arena->allocate(32);
+        second = arena->allocate(32);
+        step = 1;
+        step.notify_one();
+        step.wait(1);
+        // the thread's slab is retired when it exits, after the arena is gone.
+    });
+
+    step.wait(0);
+    logger::LogArena::release(first);
+    arena.reset();
+    // a log released after the Logger is gone.
+    std::memset(second, 0, 32);
+    logger::LogArena::release(second);
+    step = 2;
+    step.notify_one();
+    thread.join();
+}
+
+int main()
+{
+    testRecycling();
+    testCrossThreadRelease();
+    testOutlivingArena();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "logger/LogQueue.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+static const logger::Callsite& info = SHUVLOG_CALLSITE(logger::Level::kInfo);
+static const logger::Callsite& debug = SHUVLOG_CALLSITE(logger::Level::kDebug);
+static const logger::Callsite& warning = SHUVLOG_CALLSITE(logger::Level::kWarning);
+
+static logger::Settings makeSettings(
+    const logger::QueueBackend backend,
+    const logger::OverflowPolicy policy,
+    const std::size_t capacity
+)
+{
+    logger::Settings settings;
+
+    settings.setQueueBackend(backend);
+    settings.setQueueCapacity(capacity);
+    settings.setThreadBufferCapacity(capacity);
+    settings.setOverflowPolicy(policy);
+    return settings;
+}
+
+static std::vector<std::string> popAll(logger::LogQueue& queue)
+{
+    std::vector<std::string> messages;
+
+    while (std::optional<Log> log = queue.pop()) {
+        messages.emplace_back(log->getMessage());
+    }
+    return messages;
+}
+
+/**
+ * @brief   A full queue drops the pushed logs, and counts them per level.
+ */
+static void testDropNewest()
+{
+    logger::LogQueue queue;
+
+    queue.configure(makeSettings(logger::QueueBackend::kLockFree, logger::OverflowPolicy::kDropNewest, 8));
+    for (int k = 0; k < 20; ++k) {
+        queue.push(Log{ std::to_string(k), info });
+    }
+    queue.push(Log{ "debug", debug });
+
+    const std::vector<std::string> messages = popAll(queue);
+
+    CHECK(messages.size() == 8);
+    CHECK(!messages.empty() && messages.front() == "0" && messages.back() == "7");
+    CHECK(queue.getDroppedCount(logger::Level::kInfo) == 12);
+    CHECK(queue.getDroppedCount(logger::Level::kDebug) == 1);
+    CHECK(queue.getDroppedCount(logger::Level::kWarning) == 0);
+}
+
+/**
+ * @brief   A full queue drops its oldest logs to make room for the pushed
+ *          ones.
+ */
+static void testDropOldest()
+{
+    logger::LogQueue queue;
+    logger::Settings settings = makeSettings(logger::QueueBackend::kMutex, logger::OverflowPolicy::kDropOldest, 0);
+
+    settings.setMaxQueuedLogs(8);
+    queue.configure(settings);
+    for (int k = 0; k < 20; ++k) {
+        queue.push(Log{ std::to_string(k), info });
+    }
+
+    const std::vector<std::string> messages = popAll(queue);
+
+    CHECK(messages.size() == 8);
+    CHECK(!messages.empty() && messages.front() == "12" && messages.back() == "19");
+    CHECK(queue.getDroppedCount(logger::Level::kInfo) == 12);
+}
+
+/**
+ * @brief   Low levels are dropped, higher levels wait for room.
+ */
+static void testDropByLevel()
+{
+    logger::LogQueue queue;
+
+    queue.configure(makeSettings(logger::QueueBackend::kLockFree, logger::OverflowPolicy::kDropByLevel, 4));
+    for (int k = 0; k < 4; ++k) {
+        queue.push(Log{ std::to_string(k), info });
+    }
+    queue.push(Log{ "debug", debug });
+    CHECK(queue.getDroppedCount(logger::Level::kDebug) == 1);
+
+    // blocks until the consumer pops a log.
+    std::thread producer([&queue] { queue.push(Log{ "warning", warning }); });
+    std::vector<std::string> messages;
+
+    while (messages.size() < 5) {
+        if (std::optional<Log> log = queue.pop()) {
+            messages.emplace_back(log->getMessage());
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    CHECK(messages.back() == "warning");
+    CHECK(queue.getDroppedCount(logger::Level::kWarning) == 0);
+}
+
+/**
+ * @brief   Producers sleeping on a full queue are released by the consumer
+ *          draining it, and by closing the queue.
+ */
+static void testBlockedProducers()
+{
+    logger::LogQueue queue;
+    logger::Settings settings = makeSettings(logger::QueueBackend::kMutex, logger::OverflowPolicy::kBlock, 0);
+
+    settings.setMaxQueuedLogs(2);
+    queue.configure(settings);
+    queue.push(Log{ "0", info });
+    queue.push(Log{ "1", info });
+
+    std::thread producer([&queue] { queue.push(Log{ "2", info }); });
+    std::vector<Log> batch;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.drainTo(batch);
+    producer.join();
+    CHECK(batch.size() == 2);
+    CHECK(popAll(queue) == std::vector<std::string>{ "2" });
+
+    queue.push(Log{ "3", info });
+    queue.push(Log{ "4", info });
+
+    std::vector<std::thread> producers;
+
+    for (int k = 0; k < 4; ++k) {
+        producers.emplace_back([&queue] { queue.push(Log{ "blocked", info }); });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    for (std::thread& blocked : producers) {
+        blocked.join();
+    }
+    CHECK(queue.getDroppedCount(logger::Level::kInfo) == 4);
+    CHECK(popAll(queue) == std::vector<std::string>({ "3", "4" }));
+}
+
+/**
+ * @brief   Producers blocked on a full queue lose nothing, and each one's
+ *          logs come out in order.
+ */
+static void testMultiProducer(const logger::QueueBackend backend)
+{
+    constexpr int kProducers = 8;
+    constexpr int kLogsPerProducer = 20000;
+
+    logger::LogQueue queue;
+
+    queue.configure(makeSettings(backend, logger::OverflowPolicy::kBlock, 256));
+
+    std::vector<std::thread> producers;
+
+    for (int producer = 0; producer < kProducers; ++producer) {
+        producers.emplace_back([&queue, producer] {
+            for (int k = 0; k < kLogsPerProducer; ++k) {
+                queue.push(Log{ std::format("{} {}", producer, k), info });
+            }
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    int popped = 0;
+
+    while (popped < kProducers * kLogsPerProducer) {
+        const std::optional<Log> log = queue.pop();
+
+        if (!log) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const std::string_view message = log->getMessage();
+        const std::size_t space = message.find(' ');
+        int producer = -1;
+        int k = -1;
+
+        std::from_chars(message.data(), message.data() + space, producer);
+        std::from_chars(message.data() + space + 1, message.data() + message.size(), k);
+        CHECK(producer >= 0 && producer < kProducers);
+        if (producer >= 0 && producer < kProducers) {
+            CHECK(k == next[producer]);
+            next[producer] = k + 1;
+        }
+        ++popped;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    CHECK(!queue.pop());
+    CHECK(queue.getDroppedCount(logger::Level::kInfo) == 0);
+}
+
+int main()
+{
+    testDropNewest();
+    testDropOldest();
+    testDropByLevel();
+    testBlockedProducers();
+    testMultiProducer(logger::QueueBackend::kMutex);
+    testMultiProducer(logger::QueueBackend::kLockFree);
+    testMultiProducer(logger::QueueBackend::kPerThread);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+/**
+ * @class   SelfRemovingSink
+ * @brief   Tries to detach itself from the Logger while it writes.
+ */
+class SelfRemovingSink final : public logger::Sink
+{
+public:
+    SelfRemovingSink()
+        : Sink(logger::sink::Settings())
+    {}
+
+    void write(const Log& /*log*/) override
+    {
+        if (self) {
+            removals.push_back(Logger::getInstance().removeSink(self));
+            ++removalCount;
+        }
+    }
+
+    void writeHeader(
+        const std::string& /*projectName*/,
+        int /*argc*/,
+        const char* /*argv*/[],
+        const logger::BuildInfo& /*buildInfo*/,
+        const logger::Settings& /*settings*/
+    ) override
+    {}
+
+    void flush() override {}
+    void close() override { isClosed = true; }
+
+    std::shared_ptr<logger::Sink> self;
+    std::vector<bool> removals;
+    std::atomic<int> removalCount{0};
+    std::atomic<bool> isClosed{false};
+};
+
+/**
+ * @brief   A sink can't detach itself from the worker thread, which would
+ *          wait for itself forever: removeSink() refuses, and the sink can
+ *          still be detached from another thread.
+ */
+int main(const int argc, const char* argv[])
+{
+    using namespace logger;
+
+    Logger& logger = Logger::getInstance();
+    const auto sink = logger.addSink<SelfRemovingSink>();
+    const auto other = logger.addSink<TestSink>();
+
+    sink->self = sink;
+    Logger::initialize("RemoveSink", argc, argv, BuildInfo::unknown(), Settings());
+
+    LOG_INFO("first");
+    LOG_INFO("second");
+    while (sink->removalCount.load() < 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK(!sink->isClosed);
+    CHECK(logger.removeSink(sink));
+    CHECK(sink->isClosed);
+    sink->self = nullptr;
+
+    LOG_INFO("third");
+    logger.shutdown();
+
+    CHECK(sink->removals == std::vector<bool>({ false, false }));
+
+    const std::vector<std::string> messages = other->getMessages();
+
+    // followed by the shutdown notice.
+    CHECK(messages.size() == 4 && messages[0] == "first" && messages[1] == "second" && messages[2] == "third");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "logger/Sinks/RingBufferSink.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+static const logger::Callsite& info = SHUVLOG_CALLSITE(logger::Level::kInfo);
+static const logger::Callsite& error = SHUVLOG_CALLSITE(logger::Level::kError);
+
+static void writeAll(logger::RingBufferSink& sink, const std::vector<std::string>& messages)
+{
+    for (const std::string& message : messages) {
+        sink.write(Log{ message, info });
+    }
+}
+
+/**
+ * @return  The index of a new thread that logged to the sink and exited.
+ */
+static uint32_t recordFromExitedThread(logger::RingBufferSink& sink, const char* label)
+{
+    uint32_t index = 0;
+
+    std::thread([&] {
+        logger::setThreadLabel(label);
+
+        const Log log{ "from another thread", info };
+
+        index = log.getThreadIndex();
+        sink.write(log);
+    }).join();
+    return index;
+}
+
+/**
+ * @return  Whether the thread of an index is still registered, once the
+ *          registry reclaimed what it could.
+ */
+static bool isRegistered(const uint32_t index, const std::string& label)
+{
+    auto& threads = logger::ThreadRegistry::getInstance();
+
+    threads.reclaim(threads.advanceEpoch());
+    return threads.get(index).label == label;
+}
+
+/**
+ * @brief   Once full, the buffer keeps the last logs, in order.
+ */
+static void testOverflow()
+{
+    const auto target = std::make_shared<TestSink>();
+    logger::RingBufferSink sink(target, 4);
+
+    writeAll(sink, { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9" });
+    CHECK(sink.getSize() == 4);
+    CHECK(target->getMessages().empty());
+
+    sink.dump();
+    CHECK(sink.getSize() == 0);
+    CHECK(target->getMessages() == std::vector<std::string>({ "6", "7", "8", "9" }));
+
+    // dumping an empty buffer writes nothing.
+    sink.dump();
+    CHECK(target->getMessages().size() == 4);
+}
+
+/**
+ * @brief   A log of the trigger level dumps the retained logs, itself
+ *          included, and the buffer starts over.
+ */
+static void testTrigger()
+{
+    const auto target = std::make_shared<TestSink>();
+    logger::RingBufferSink sink(target, 8, logger::Level::kError);
+
+    writeAll(sink, { "a", "b" });
+    sink.write(Log{ "failure", error });
+    CHECK(sink.getSize() == 0);
+    CHECK(target->getMessages() == std::vector<std::string>({ "a", "b", "failure" }));
+
+    writeAll(sink, { "c" });
+    CHECK(sink.getSize() == 1);
+    CHECK(target->getMessages().size() == 3);
+}
+
+/**
+ * @brief   Another thread can dump the buffer while it is being written.
+ */
+static void testDumpFromAnotherThread()
+{
+    constexpr int kLogs = 10'000;
+
+    const auto target = std::make_shared<TestSink>();
+    logger::RingBufferSink sink(target, 64);
+
+    std::thread dumper([&sink] {
+        for (int k = 0; k < 100; ++k) {
+            sink.dump();
+            std::this_thread::yield();
+        }
+    });
+
+    for (int k = 0; k < kLogs; ++k) {
+        sink.write(Log{ std::to_string(k), info });
+    }
+    dumper.join();
+    sink.dump();
+
+    // whatever has been overwritten in-between, dumps come out in order.
+    const std::vector<std::string> messages = target->getMessages();
+    int previous = -1;
+
+    for (const std::string& message : messages) {
+        CHECK(std::stoi(message) > previous);
+        previous = std::stoi(message);
+    }
+    CHECK(previous == kLogs - 1);
+}
+
+/**
+ * @brief   Exited threads stay registered while the buffer holds their logs,
+ *          and are released once the logs are dumped, overwritten, or the
+ *          sink destroyed.
+ */
+static void testThreadPins()
+{
+    const auto target = std::make_shared<TestSink>();
+    auto sink = std::make_unique<logger::RingBufferSink>(target, 4);
+
+    const uint32_t dumped = recordFromExitedThread(*sink, "Dumped");
+
+    CHECK(isRegistered(dumped, "Dumped"));
+    sink->dump();
+    CHECK(!isRegistered(dumped, "Dumped"));
+
+    const uint32_t overwritten = recordFromExitedThread(*sink, "Overwritten");
+
+    writeAll(*sink, { "0", "1", "2" });
+    CHECK(isRegistered(overwritten, "Overwritten"));
+    writeAll(*sink, { "3" });
+    CHECK(!isRegistered(overwritten, "Overwritten"));
+
+    const uint32_t destroyed = recordFromExitedThread(*sink, "Destroyed");
+
+    CHECK(isRegistered(destroyed, "Destroyed"));
+    sink.reset();
+    CHECK(!isRegistered(destroyed, "Destroyed"));
+}
+
+int main()
+{
+    testOverflow();
+    testTrigger();
+    testDumpFromAnotherThread();
+    testThreadPins();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "logger/MpscRingBuffer.h"
+#include "logger/SpscRingBuffer.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+struct Item
+{
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+/**
+ * @brief   Many producers push at once into a small buffer: every item comes
+ *          out exactly once, and each producer's items come out in order.
+ */
+static void testMpscStress()
+{
+    constexpr uint32_t kProducers = 8;
+    constexpr uint32_t kItemsPerProducer = 100000;
+
+    MpscRingBuffer<Item> buffer(1024);
+    std::vector<std::thread> producers;
+
+    for (uint32_t producer = 0; producer < kProducers; ++producer) {
+        producers.emplace_back([&buffer, producer] {
+            for (uint32_t sequence = 0; sequence < kItemsPerProducer; ++sequence) {
+                while (!buffer.tryPush(Item{ producer, sequence })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(kProducers, 0);
+    uint64_t popped = 0;
+
+    while (popped < uint64_t{kProducers} * kItemsPerProducer) {
+        const std::optional<Item> item = buffer.pop();
+
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+        CHECK(item->producer < kProducers);
+        CHECK(item->sequence == next[item->producer]);
+        next[item->producer] = item->sequence + 1;
+        ++popped;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    CHECK(buffer.empty());
+    CHECK(!buffer.pop());
+}
+
+/**
+ * @brief   A full buffer refuses new items, and leaves them untouched.
+ */
+static void testMpscFull()
+{
+    MpscRingBuffer<std::unique_ptr<int>> buffer(3);
+
+    CHECK(buffer.capacity() == 4);
+    for (int k = 0; k < 4; ++k) {
+        CHECK(buffer.tryPush(std::make_unique<int>(k)));
+    }
+
+    auto refused = std::make_unique<int>(4);
+
+    CHECK(!buffer.tryPush(std::move(refused)));
+    CHECK(refused && *refused == 4);
+    CHECK(buffer.size() == 4);
+    CHECK(**buffer.pop() == 0);
+    CHECK(buffer.tryPush(std::move(refused)));
+    for (int k = 1; k <= 4; ++k) {
+        CHECK(**buffer.pop() == k);
+    }
+    CHECK(!buffer.pop());
+}
+
+/**
+ * @brief   One producer, one consumer: items come out in order, across many
+ *          laps of the buffer.
+ */
+static void testSpscStress()
+{
+    constexpr uint32_t kItems = 1000000;
+
+    SpscRingBuffer<uint32_t> buffer(256);
+    std::thread producer([&buffer] {
+        for (uint32_t k = 0; k < kItems; ++k) {
+            uint32_t value = k;
+
+            while (!buffer.tryPush(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (uint32_t expected = 0; expected < kItems;) {
+        const std::optional<uint32_t> value = buffer.pop();
+
+        if (!value) {
+            std::this_thread::yield();
+            continue;
+        }
+        CHECK(*value == expected);
+        ++expected;
+    }
+    producer.join();
+    CHECK(buffer.empty());
+}
+
+static void testSpscFull()
+{
+    SpscRingBuffer<std::unique_ptr<int>> buffer(2);
+
+    CHECK(buffer.tryPush(std::make_unique<int>(0)));
+    CHECK(buffer.tryPush(std::make_unique<int>(1)));
+
+    auto refused = std::make_unique<int>(2);
+
+    CHECK(!buffer.tryPush(std::move(refused)));
+    CHECK(refused && *refused == 2);
+    CHECK(**buffer.pop() == 0);
+    CHECK(**buffer.pop() == 1);
+    CHECK(!buffer.pop());
+}
+
+int main()
+{
+    testMpscStress();
+    testMpscFull();
+    testSpscStress();
+    testSpscFull();
+    return failures == 0 ? 0 : 1;
+}
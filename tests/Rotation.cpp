@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "logger/Sinks/LogFileSink.h"
+#include "TestSink.h"
+
+namespace fs = std::filesystem;
+
+static int failures = 0;
+
+/**
+ * @return  The files of a directory whose name starts with a stem.
+ */
+static std::vector<fs::path> listFiles(const fs::path& directory, const std::string& stem)
+{
+    std::vector<fs::path> files;
+
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        if (entry.path().filename().string().starts_with(stem)) {
+            files.push_back(entry.path());
+        }
+    }
+    return files;
+}
+
+/**
+ * @brief   Files are rotated once they reach their size, each starts with the
+ *          header, no log is lost between them, and retention only keeps the
+ *          newest ones.
+ */
+int main(const int argc, const char* argv[])
+{
+    constexpr int kLogs = 5000;
+    constexpr std::size_t kMaxBytes = 16 * 1024;
+
+    fs::remove_all("rotation");
+    fs::create_directories("rotation");
+
+    Logger& logger = Logger::getInstance();
+    auto all = logger.addSink<logger::LogFileSink>("rotation/all.log");
+    auto retained = logger.addSink<logger::LogFileSink>("rotation/retained.log");
+
+    all->setRotationPolicy({ .maxBytes = kMaxBytes, .compression = logger::sink::Compression::kNone });
+    retained->setRotationPolicy({ .maxBytes = kMaxBytes, .maxFiles = 2, .compression = logger::sink::Compression::kNone });
+
+    logger::Settings settings;
+
+    settings.setMaxBatchSize(64);
+    Logger::initialize("Rotation", argc, argv, logger::BuildInfo::unknown(), settings);
+
+    for (int k = 0; k < kLogs; ++k) {
+        LOG_INFO("line {}", k);
+    }
+    logger.shutdown();
+
+    // destroying the sinks waits for their rotation threads.
+    logger.removeSink(all);
+    logger.removeSink(retained);
+    all.reset();
+    retained.reset();
+
+    const std::vector<fs::path> files = listFiles("rotation", "all.");
+    std::vector<int> seen(kLogs, 0);
+
+    CHECK(files.size() > 2);
+    for (const fs::path& path : files) {
+        std::ifstream file(path);
+        std::string line;
+
+        CHECK(path.extension() == ".log");
+        std::getline(file, line);
+        CHECK(line.starts_with("/****"));
+        while (std::getline(file, line)) {
+            const std::size_t found = line.find("line ");
+            int k = -1;
+
+            if (found == std::string::npos) {
+                continue;
+            }
+            std::from_chars(line.data() + found + 5, line.data() + line.size(), k);
+            if (k >= 0 && k < kLogs) {
+                ++seen[k];
+            }
+        }
+    }
+    CHECK(std::ranges::all_of(seen, [](const int count) { return count == 1; }));
+
+    // the active file, and the two newest rotated ones.
+    CHECK(listFiles("rotation", "retained.").size() == 3);
+    return failures == 0 ? 0 : 1;
+}
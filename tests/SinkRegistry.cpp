@@ -0,0 +1,64 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "logger/SinkRegistry.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+/**
+ * @brief   A reader keeps reading snapshots while a writer replaces them:
+ *          every snapshot read is whole (and alive, which ASan checks), and
+ *          once the writer waited for the reader, older snapshots are never
+ *          read again.
+ */
+int main()
+{
+    constexpr std::size_t kGenerations = 1000;
+
+    logger::SinkRegistry registry;
+    const auto sink = std::make_shared<TestSink>();
+    std::atomic<std::size_t> published{0};
+    std::atomic<bool> isDone{false};
+    std::atomic<int> readerFailures{0};
+
+    // snapshot N holds N entries, all of the same sink.
+    std::thread reader([&] {
+        while (!isDone.load(std::memory_order_acquire)) {
+            const std::size_t minimum = published.load(std::memory_order_acquire);
+            const logger::SinkRegistry::Reader snapshot(registry);
+            const std::size_t generation = snapshot->entries.size();
+
+            if (generation < minimum || generation > kGenerations) {
+                ++readerFailures;
+            }
+            for (const auto& entry : snapshot->entries) {
+                if (entry.sink != sink || entry.worker) {
+                    ++readerFailures;
+                }
+            }
+        }
+    });
+
+    for (std::size_t generation = 1; generation <= kGenerations; ++generation) {
+        logger::SinkRegistry::Snapshot next = registry.current();
+
+        next.entries.push_back({ sink, nullptr });
+        registry.publish(std::move(next));
+        if (generation % 10 == 0) {
+            registry.waitForReader();
+            published.store(generation, std::memory_order_release);
+        }
+    }
+    isDone.store(true, std::memory_order_release);
+    reader.join();
+
+    CHECK(readerFailures == 0);
+    CHECK(!registry.empty());
+    CHECK(registry.current().entries.size() == kGenerations);
+    // the entries of the current snapshot, and the caller.
+    registry.waitForReader();
+    CHECK(sink.use_count() == static_cast<long>(kGenerations) + 1);
+    return failures == 0 ? 0 : 1;
+}
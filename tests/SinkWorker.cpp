@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+/**
+ * @class   StalledSink
+ * @brief   A sink whose writes wait until it is unblocked, like a sink stuck
+ *          on a slow disk.
+ */
+class StalledSink final : public logger::Sink
+{
+public:
+    StalledSink()
+        : Sink(logger::sink::Settings())
+    {}
+
+    void write(const Log& log) override
+    {
+        std::unique_lock lock(_mutex);
+
+        isWriting = true;
+        _cvar.wait(lock, [this] { return _isUnblocked; });
+        if (isClosed) {
+            isWrittenAfterClose = true;
+        }
+        _messages.emplace_back(log.getMessage());
+    }
+
+    void writeHeader(
+        const std::string& /*projectName*/,
+        int /*argc*/,
+        const char* /*argv*/[],
+        const logger::BuildInfo& /*buildInfo*/,
+        const logger::Settings& /*settings*/
+    ) override
+    {}
+
+    void flush() override {}
+    void close() override { isClosed = true; }
+
+    void unblock()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _isUnblocked = true;
+        }
+        _cvar.notify_all();
+    }
+
+    [[nodiscard]] std::vector<std::string> getMessages() const
+    {
+        std::lock_guard lock(_mutex);
+
+        return _messages;
+    }
+
+    std::atomic<bool> isWriting{false};
+    std::atomic<bool> isClosed{false};
+    std::atomic<bool> isWrittenAfterClose{false};
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _cvar;
+    bool _isUnblocked = false;
+    std::vector<std::string> _messages;
+};
+
+template<typename Predicate>
+static void waitUntil(const Predicate& predicate)
+{
+    while (!predicate()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * @brief   A stalled sink only delays itself: once its queue is full, batches
+ *          are dropped for it alone, which its lag tells. Shutting down still
+ *          writes every queued batch before closing it.
+ */
+int main(const int argc, const char* argv[])
+{
+    using namespace logger;
+
+    Logger& logger = Logger::getInstance();
+    const auto stalled = logger.addSink<StalledSink>();
+    const auto healthy = logger.addSink<TestSink>();
+    Settings settings;
+
+    stalled->setThreadSettings({ .queueCapacity = 2 });
+    settings.setThreadPerSink(true);
+    Logger::initialize("SinkWorker", argc, argv, BuildInfo::unknown(), settings);
+
+    // one batch per log: each is handed to the sinks before the next one.
+    LOG_INFO("0");
+    waitUntil([&] { return stalled->isWriting.load(); });
+    for (int k = 1; k < 6; ++k) {
+        LOG_INFO("{}", k);
+        waitUntil([&] { return healthy->getMessages().size() == static_cast<std::size_t>(k) + 1; });
+    }
+
+    // "0" being written, "1" and "2" queued, the others dropped.
+    const sink::Lag lag = logger.getSinkLag(stalled);
+
+    CHECK(lag.pendingLogs == 3);
+    CHECK(lag.pendingBatches == 2);
+    CHECK(lag.droppedLogs == 3);
+
+    const sink::Lag healthyLag = logger.getSinkLag(healthy);
+
+    CHECK(healthyLag.pendingLogs == 0 && healthyLag.droppedLogs == 0);
+    CHECK(healthy->getMessages() == std::vector<std::string>({ "0", "1", "2", "3", "4", "5" }));
+
+    // shutting down waits for the stalled sink to write its queue.
+    std::thread shutdown([&logger] { logger.shutdown(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(!stalled->isClosed);
+    stalled->unblock();
+    shutdown.join();
+
+    const std::vector<std::string> messages = stalled->getMessages();
+
+    CHECK(stalled->isClosed);
+    CHECK(!stalled->isWrittenAfterClose);
+    CHECK(messages.size() >= 3 && messages[0] == "0" && messages[1] == "1" && messages[2] == "2");
+    CHECK(std::ranges::find(messages, "3") == messages.end());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#ifndef SHUVLOG_TESTS_TESTSINK_H
+#define SHUVLOG_TESTS_TESTSINK_H
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "logger/Sink.h"
+
+/**
+ * @class   TestSink
+ * @brief   Keeps the messages it receives, for tests to check them.
+ */
+class TestSink final : public logger::Sink
+{
+public:
+    TestSink()
+        : Sink(logger::sink::Settings())
+    {}
+
+    void write(const Log& log) override
+    {
+        std::lock_guard lock(_mutex);
+
+        _messages.emplace_back(log.getMessage());
+    }
+
+    void writeHeader(
+        const std::string& /*projectName*/,
+        int /*argc*/,
+        const char* /*argv*/[],
+        const logger::BuildInfo& /*buildInfo*/,
+        const logger::Settings& /*settings*/
+    ) override
+    {}
+
+    void flush() override {}
+    void close() override {}
+
+    [[nodiscard]] std::vector<std::string> getMessages() const
+    {
+        std::lock_guard lock(_mutex);
+
+        return _messages;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<std::string> _messages;
+};
+
+/**
+ * @brief   Prints the failed check, and counts it.
+ */
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                             \
+        }                                                                           \
+    } while (false)
+
+#endif //SHUVLOG_TESTS_TESTSINK_H
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <format>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/Logger.h"
+#include "logger/Thread.h"
+#include "TestSink.h"
+
+static int failures = 0;
+
+/**
+ * @brief   Keeps the thread each log was attributed to.
+ */
+class ThreadSink final : public logger::Sink
+{
+public:
+    ThreadSink()
+        : Sink(logger::sink::Settings())
+    {}
+
+    void write(const Log& log) override
+    {
+        std::lock_guard lock(_mutex);
+
+        // resolved now: the thread may be long gone.
+        _logs.emplace_back(std::string(log.getMessage()), std::string(log.getThreadName()), log.getThreadIndex());
+    }
+
+    void writeHeader(const std::string&, int, const char*[], const logger::BuildInfo&, const logger::Settings&) override {}
+    void flush() override {}
+    void close() override {}
+
+    struct Entry
+    {
+        std::string message;
+        std::string label;
+        uint32_t index;
+    };
+
+    std::vector<Entry> getLogs() const
+    {
+        std::lock_guard lock(_mutex);
+
+        return _logs;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<Entry> _logs;
+};
+
+int main(const int argc, const char* argv[])
+{
+    constexpr int kRounds = 200;
+    constexpr int kThreadsPerRound = 8;
+
+    const auto sink = Logger::getInstance().addSink<ThreadSink>();
+    logger::Settings settings;
+
+    settings.setFlushIntervalMs(1);
+    Logger::initialize("ThreadRegistry", argc, argv, logger::BuildInfo::unknown(), settings);
+
+    // threads come and go, some relabeling themselves, while their logs are
+    // still queued.
+    for (int round = 0; round < kRounds; ++round) {
+        std::vector<std::thread> threads;
+
+        for (int k = 0; k < kThreadsPerRound; ++k) {
+            threads.emplace_back([round, k] {
+                const std::string label = std::format("Worker{}-{}", round, k);
+
+                logger::setThreadLabel(label.c_str());
+                LOG_INFO("{}", label);
+                if (k % 2 == 0) {
+                    const std::string relabel = label + "b";
+
+                    logger::setThreadLabel(relabel.c_str());
+                    LOG_INFO("{}", relabel);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    Logger::getInstance().shutdown();
+
+    const std::vector<ThreadSink::Entry> logs = sink->getLogs();
+    uint32_t maxIndex = 0;
+    std::size_t workerLogs = 0;
+
+    for (const ThreadSink::Entry& log : logs) {
+        if (!log.message.starts_with("Worker")) {
+            continue;
+        }
+        ++workerLogs;
+        // a log shows the label its thread had when the log was written,
+        // never another thread's.
+        CHECK(log.label.starts_with(log.message.substr(0, log.message.find_last_not_of('b') + 1)));
+        maxIndex = std::max(maxIndex, log.index);
+    }
+
+    CHECK(workerLogs == kRounds * (kThreadsPerRound + kThreadsPerRound / 2));
+    // indices of exited threads are reused.
+    CHECK(maxIndex < kRounds * kThreadsPerRound / 2);
+    return failures == 0 ? 0 : 1;
+}
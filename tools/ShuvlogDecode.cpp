@@ -0,0 +1,473 @@
+/**
+ * shuvlog-decode: turns files written by logger::BinaryFileSink back into the
+ * text formats of the other file sinks.
+ *
+ * Usage: shuvlog-decode [--format log|ndjson] [--jobs N] <file.shlog>...
+ *
+ * Each input is decoded next to itself, with its extension replaced
+ * (e.g. "app.shlog" -> "app.log").
+ *
+ * A file is decoded in two passes: a sequential one that reads the thread and
+ * callsite tables and splits the file at its sync records, then a parallel one
+ * where each thread renders a range of records on its own.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "logger/BinaryFormat.h"
+#include "logger/JsonEncoder.h"
+#include "logger/Level.h"
+#include "logger/Sink.h"
+#include "logger/TextEncoder.h"
+#include "logger/Timestamp.h"
+
+namespace fs = std::filesystem;
+namespace binary = logger::binary;
+
+enum class Format
+{
+    kLog,
+    kNdJson,
+};
+
+struct Thread
+{
+    std::string_view label;
+    std::string_view prettyId;
+};
+
+struct Callsite
+{
+    uint64_t line;
+    uint64_t column;
+    std::string_view file;
+    std::string_view function;
+};
+
+/**
+ * @brief   Everything the first pass learns about a file.
+ */
+struct Index
+{
+    std::vector<std::pair<std::string_view, std::string_view>> header;
+    /// Formatting settings of the sink that wrote the file.
+    logger::sink::Settings settings;
+    std::vector<Thread> threads;
+    std::vector<Callsite> callsites;
+    /// Ranges of records that can be decoded independently.
+    std::vector<std::pair<std::size_t, std::size_t>> chunks;
+    /// Whether the file ends with an incomplete record (e.g. after a crash).
+    bool isTruncated = false;
+};
+
+/// Amount of input a decoding thread gets at once.
+static constexpr std::size_t kChunkSize = 1024 * 1024;
+
+static std::optional<std::string> readFile(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) {
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+/**
+ * @brief   Reads the framing of every record, and the definitions.
+ *
+ * @return  @code std::nullopt@endcode if the file is malformed.
+ */
+static std::optional<Index> indexFile(std::string_view records)
+{
+    Index index;
+    binary::Cursor cursor(records);
+    std::size_t chunkStart = 0;
+
+    while (!cursor.atEnd()) {
+        const std::size_t offset = cursor.getOffset();
+        const auto tag = cursor.readBytes(1);
+        const auto size = cursor.readVarint();
+        const auto payload = size ? cursor.readBytes(*size) : std::nullopt;
+
+        // only the last record can be incomplete, everything before it is kept.
+        if (!tag || !payload) {
+            index.isTruncated = true;
+            records = records.substr(0, offset);
+            break;
+        }
+
+        binary::Cursor fields(*payload);
+
+        switch (static_cast<binary::Record>((*tag)[0])) {
+            case binary::Record::kHeader: {
+                const uint64_t count = fields.readVarint().value_or(0);
+
+                for (uint64_t k = 0; k < count; ++k) {
+                    const auto key = fields.readString();
+                    const auto value = fields.readString();
+
+                    if (!key || !value) {
+                        return std::nullopt;
+                    }
+                    index.header.emplace_back(*key, *value);
+                }
+                break;
+            }
+
+            case binary::Record::kSettings: {
+                const auto flags = fields.readVarint();
+
+                if (!flags) {
+                    return std::nullopt;
+                }
+                index.settings = binary::toSettings(*flags);
+                break;
+            }
+
+            case binary::Record::kThread: {
+                const auto id = fields.readVarint();
+                const auto label = fields.readString();
+                const auto prettyId = fields.readString();
+
+                if (!id || !label || !prettyId || *id != index.threads.size()) {
+                    return std::nullopt;
+                }
+                index.threads.push_back({ *label, *prettyId });
+                break;
+            }
+
+            case binary::Record::kCallsite: {
+                const auto id = fields.readVarint();
+                const auto line = fields.readVarint();
+                const auto column = fields.readVarint();
+                const auto file = fields.readString();
+                const auto function = fields.readString();
+
+                if (!id || !line || !column || !file || !function || *id != index.callsites.size()) {
+                    return std::nullopt;
+                }
+                index.callsites.push_back({ *line, *column, *file, *function });
+                break;
+            }
+
+            case binary::Record::kSync: {
+                if (offset - chunkStart >= kChunkSize) {
+                    index.chunks.emplace_back(chunkStart, offset);
+                    chunkStart = offset;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+    if (chunkStart != records.size()) {
+        index.chunks.emplace_back(chunkStart, records.size());
+    }
+    return index;
+}
+
+static std::string_view findHeaderValue(const Index& index, const std::string_view key)
+{
+    for (const auto& [k, value] : index.header) {
+        if (k == key) {
+            return value;
+        }
+    }
+    return {};
+}
+
+static void renderHeader(std::string& output, const Index& index, const Format format)
+{
+    if (index.header.empty()) {
+        return;
+    }
+
+    if (format == Format::kNdJson) {
+        output += '{';
+        for (const auto& [key, value] : index.header) {
+            logger::json::appendString(output, key);
+            output += ':';
+            if (key == "levelMask" && findHeaderValue(index, "filterMode") == "Explicit") {
+                // explicit masks are rendered as an array of levels
+                output += '[';
+                for (const auto level : std::views::split(value, std::string_view(", "))) {
+                    logger::json::appendString(output, std::string_view(level));
+                    output += ',';
+                }
+                output.back() = ']';
+            } else {
+                logger::json::appendString(output, value);
+            }
+            output += ',';
+        }
+        output.back() = '}';
+        output += '\n';
+        return;
+    }
+
+    const auto value = [&](const std::string_view key) { return findHeaderValue(index, key); };
+    const std::string_view levelMask = value("levelMask");
+    const std::pair<std::string_view, std::string> infos[] = {
+        { "",                   ""                                                          },
+        { "Project",            std::string(value("projectName"))                           },
+        { "Version",            std::string(value("version"))                               },
+        { "Build type",         std::string(value("buildType"))                             },
+        { "",                   ""                                                          },
+        { "Filter mode",        std::string(value("filterMode"))                            },
+        { "Level(s)",           std::string(levelMask.empty() ? "None" : levelMask)         },
+        { "",                   ""                                                          },
+        { "Command",            std::string(value("command"))                               },
+        { "Start time",         std::string(value("startTime"))                             },
+        { "",                   ""                                                          },
+        { "OS",                 std::format("{} {}", value("osName"), value("kernelVersion")) },
+        { "Compiler",           std::string(value("compiler"))                              },
+        { "Compilation flags",  std::string(value("compilationFlags"))                      },
+        { "Build system",       std::string(value("buildSystem"))                           },
+        { "",                   ""                                                          },
+    };
+    std::size_t maxKeyLen = 0;
+
+    for (const auto& [label, _] : infos) {
+        maxKeyLen = std::max(maxKeyLen, label.size());
+    }
+
+    output += "/*************************************************\n";
+    for (const auto& [label, info] : infos) {
+        if (label.empty()) {
+            output += "|\n";
+            continue;
+        }
+        std::format_to(std::back_inserter(output), "|   {:{}}  :  {}\n", label, maxKeyLen, info);
+    }
+    output += "\\*************************************************\n\n";
+}
+
+/**
+ * @brief   Renders the logs of a chunk, which starts with a sync record.
+ *
+ * @return  @code false@endcode if the chunk is malformed.
+ */
+static bool renderChunk(
+    std::string& output,
+    const std::string_view chunk,
+    const Index& index,
+    const Format format
+)
+{
+    TimestampRenderer timestampRenderer;
+    binary::Cursor cursor(chunk);
+    int64_t timestamp = 0;
+
+    while (!cursor.atEnd()) {
+        const auto tag = cursor.readBytes(1);
+        const auto size = cursor.readVarint();
+        const auto payload = size ? cursor.readBytes(*size) : std::nullopt;
+
+        if (!tag || !payload) {
+            return false;
+        }
+
+        binary::Cursor reader(*payload);
+        const auto record = static_cast<binary::Record>((*tag)[0]);
+
+        if (record == binary::Record::kSync) {
+            timestamp = static_cast<int64_t>(reader.readVarint().value_or(0));
+            continue;
+        }
+        if (record != binary::Record::kLog && record != binary::Record::kSampledLog) {
+            continue;
+        }
+
+        const auto delta = reader.readVarint();
+        const auto level = reader.readBytes(1);
+        const auto threadId = reader.readVarint();
+        const auto callsiteId = reader.readVarint();
+        const auto sampleRate = record == binary::Record::kSampledLog ? reader.readVarint() : 1;
+
+        if (!delta || !level || !threadId || !callsiteId || !sampleRate
+            || static_cast<uint8_t>((*level)[0]) >= logger::level::kCount
+            || *threadId >= index.threads.size() || *callsiteId >= index.callsites.size()) {
+            return false;
+        }
+        timestamp += binary::unzigzag(*delta);
+
+        const time_point<system_clock> time(
+            duration_cast<system_clock::duration>(nanoseconds(timestamp))
+        );
+        const auto logLevel = static_cast<logger::Level>(1 << static_cast<uint8_t>((*level)[0]));
+        const Thread& thread = index.threads[*threadId];
+        const Callsite& callsite = index.callsites[*callsiteId];
+
+        const logger::LogFields fields{
+            time,
+            logLevel,
+            thread.label,
+            thread.prettyId,
+            callsite.file,
+            callsite.function,
+            callsite.line,
+            callsite.column,
+            reader.rest(),
+            static_cast<uint32_t>(*sampleRate),
+        };
+
+        // the same encoders as NdJsonFileSink and LogFileSink.
+        if (format == Format::kNdJson) {
+            logger::json::appendLog(output, fields, timestampRenderer);
+            output += '\n';
+        } else {
+            logger::text::appendLog(output, fields, index.settings, timestampRenderer);
+        }
+    }
+    return true;
+}
+
+static bool decodeFile(const fs::path& input, const Format format, const unsigned jobs)
+{
+    const auto data = readFile(input);
+
+    if (!data) {
+        std::cerr << input.string() << ": could not open file." << std::endl;
+        return false;
+    }
+
+    const std::string_view content = *data;
+    const std::size_t prologueSize = binary::kMagic.size() + 1;
+
+    if (!content.starts_with(binary::kMagic)
+        || content.size() < prologueSize
+        || static_cast<uint8_t>(content[binary::kMagic.size()]) != binary::kVersion) {
+        std::cerr << input.string() << ": not a shuvlog binary file (or unsupported version)." << std::endl;
+        return false;
+    }
+
+    const std::string_view records = content.substr(prologueSize);
+    const auto index = indexFile(records);
+
+    if (!index) {
+        std::cerr << input.string() << ": malformed file." << std::endl;
+        return false;
+    }
+    if (index->isTruncated) {
+        std::cerr << input.string() << ": warning: last record is incomplete, and has been skipped." << std::endl;
+    }
+
+    fs::path outputPath = input;
+
+    outputPath.replace_extension(format == Format::kNdJson ? ".ndjson" : ".log");
+
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+
+    if (!output) {
+        std::cerr << outputPath.string() << ": could not open file." << std::endl;
+        return false;
+    }
+
+    std::string header;
+
+    renderHeader(header, *index, format);
+    output.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // chunks are rendered in waves, so that memory stays bounded by the wave size.
+    const std::size_t waveSize = std::size_t{jobs} * 4;
+    std::vector<std::string> rendered(waveSize);
+    bool isValid = true;
+
+    for (std::size_t first = 0; first < index->chunks.size() && isValid; first += waveSize) {
+        const std::size_t count = std::min(waveSize, index->chunks.size() - first);
+        std::atomic<std::size_t> next{0};
+        std::atomic<bool> failed{false};
+        std::vector<std::jthread> workers;
+
+        for (unsigned k = 0; k < std::min<std::size_t>(jobs, count); ++k) {
+            workers.emplace_back([&] {
+                for (std::size_t i = next++; i < count; i = next++) {
+                    const auto [begin, end] = index->chunks[first + i];
+
+                    rendered[i].clear();
+                    if (!renderChunk(rendered[i], records.substr(begin, end - begin), *index, format)) {
+                        failed = true;
+                    }
+                }
+            });
+        }
+        workers.clear();
+
+        isValid = !failed;
+        for (std::size_t i = 0; i < count; ++i) {
+            output.write(rendered[i].data(), static_cast<std::streamsize>(rendered[i].size()));
+        }
+    }
+
+    if (!isValid) {
+        std::cerr << input.string() << ": malformed file, output is incomplete." << std::endl;
+    }
+    return isValid;
+}
+
+static void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--format log|ndjson] [--jobs N] <file.shlog>...\n"
+              << "Decodes binary log files next to themselves (default format: log)." << std::endl;
+}
+
+int main(const int argc, const char* argv[])
+{
+    Format format = Format::kLog;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<fs::path> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--format" && i + 1 < argc) {
+            const std::string_view value = argv[++i];
+
+            if (value == "log") {
+                format = Format::kLog;
+            } else if (value == "ndjson") {
+                format = Format::kNdJson;
+            } else {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--help" || arg == "-h" || arg.starts_with("--")) {
+            printUsage(argv[0]);
+            return arg.starts_with("--h") || arg == "-h" ? 0 : 2;
+        } else {
+            inputs.emplace_back(arg);
+        }
+    }
+
+    if (inputs.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    bool isSuccess = true;
+
+    for (const auto& input : inputs) {
+        isSuccess &= decodeFile(input, format, jobs);
+    }
+    return isSuccess ? 0 : 1;
+}